@@ -2,12 +2,12 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 
-uniform mat4 projection;
+#include "frame_uniforms.glsl"
 
 out vec2 TexCoord;
 
 void main()
 {
-   gl_Position = projection * vec4(aPos.x, aPos.y, aPos.z, 1.0);
+   gl_Position = projection * view * vec4(aPos.x, aPos.y, aPos.z, 1.0);
    TexCoord = aTexCoord;
 }
\ No newline at end of file
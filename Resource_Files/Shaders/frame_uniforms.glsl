@@ -0,0 +1,8 @@
+// Per-frame data shared by every program, see FrameUniformData
+layout (std140) uniform FrameUniforms
+{
+   mat4 projection;
+   mat4 view;
+   vec4 viewport;
+   float time;
+};
\ No newline at end of file
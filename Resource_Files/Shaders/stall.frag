@@ -0,0 +1,70 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+flat in uint State;
+#ifdef SPRITES
+flat in int HasSprite;
+flat in vec4 SpriteRect;
+
+uniform sampler2D atlas;
+#endif
+
+// Fill colors indexed by stall state: free, occupied, reserved, accessible
+const vec3 stateColors[4] = vec3[4](
+   vec3(0.20, 0.65, 0.30),
+   vec3(0.80, 0.25, 0.20),
+   vec3(0.90, 0.70, 0.20),
+   vec3(0.20, 0.45, 0.85)
+);
+
+#include "frame_uniforms.glsl"
+
+#ifdef HEATMAP
+// Occupancy pressure of each stall state, 0 is idle and 1 is in use
+const float stateHeat[4] = float[4](0.0, 1.0, 0.6, 0.3);
+
+// Blue to red ramp through green and yellow
+vec3 heat(float t)
+{
+   return clamp(vec3(1.5 - abs(4.0 * t - 3.0), 1.5 - abs(4.0 * t - 2.0), 1.5 - abs(4.0 * t - 1.0)), 0.0, 1.0);
+}
+#endif
+
+void main()
+{
+   // Paint the stall lines along the edges of the quad
+   vec2 edge = min(TexCoord, 1.0 - TexCoord);
+   if (min(edge.x, edge.y) < 0.04)
+      FragColor = vec4(0.95, 0.95, 0.95, 1.0);
+   else
+   {
+#ifdef AGGREGATE
+      // Aggregates of many stalls carry the percentage of them taken instead of a state
+      float taken = float(min(State, 100u)) / 100.0;
+#endif
+#ifdef HEATMAP
+      // Pulse the overlay slowly so it reads as an overlay rather than the fill
+      float pulse = 0.85 + 0.15 * sin(time * 3.0);
+#ifdef AGGREGATE
+      vec3 color = heat(taken) * pulse;
+#else
+      vec3 color = heat(stateHeat[min(State, 3u)]) * pulse;
+#endif
+#elif defined(AGGREGATE)
+      vec3 color = mix(stateColors[0], stateColors[1], taken);
+#else
+      vec3 color = stateColors[min(State, 3u)];
+#endif
+#ifdef SPRITES
+      // Paint the stall's sprite over the middle of the stall
+      vec2 icon = (TexCoord - 0.2) / 0.6;
+      if (HasSprite == 1 && all(greaterThanEqual(icon, vec2(0.0))) && all(lessThanEqual(icon, vec2(1.0))))
+      {
+         vec4 sprite = texture(atlas, mix(SpriteRect.xy, SpriteRect.zw, icon));
+         color = mix(color, sprite.rgb, sprite.a);
+      }
+#endif
+      FragColor = vec4(color, 1.0);
+   }
+}
\ No newline at end of file
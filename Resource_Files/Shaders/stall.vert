@@ -0,0 +1,39 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+// Per-instance stall attributes
+layout (location = 2) in vec3 aStall; // x, y, angle
+layout (location = 3) in vec2 aSize;  // width, depth
+layout (location = 4) in uint aState;
+layout (location = 5) in uint aSprite;
+
+#include "frame_uniforms.glsl"
+
+#ifdef SPRITES
+// Atlas rectangle (u0, v0, u1, v1) of every sprite
+uniform vec4 spriteRects[64];
+uniform int spriteCount;
+#endif
+
+out vec2 TexCoord;
+flat out uint State;
+#ifdef SPRITES
+flat out int HasSprite;
+flat out vec4 SpriteRect;
+#endif
+
+void main()
+{
+   // Scale the unit quad to the stall size, rotate it and move it to the stall centre
+   vec2 local = aPos.xy * aSize;
+   float c = cos(aStall.z);
+   float s = sin(aStall.z);
+   vec2 world = vec2(c * local.x - s * local.y, s * local.x + c * local.y) + aStall.xy;
+   gl_Position = projection * view * vec4(world, aPos.z, 1.0);
+   TexCoord = aTexCoord;
+   State = aState;
+#ifdef SPRITES
+   HasSprite = aSprite < uint(spriteCount) ? 1 : 0;
+   SpriteRect = HasSprite == 1 ? spriteRects[aSprite] : vec4(0.0);
+#endif
+}
\ No newline at end of file
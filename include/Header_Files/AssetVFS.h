@@ -0,0 +1,47 @@
+#ifndef ASSET_VFS_CLASS_H
+#define ASSET_VFS_CLASS_H
+
+#include<cstddef>
+#include<string>
+#include<string_view>
+#include<unordered_map>
+#include<vector>
+#include"Header_Files/MappedFile.h"
+
+// Finds assets by their path relative to the project root (e.g. "Resource_Files/Shaders/stall.vert").
+// The root is searched for once, so every later lookup costs at most one open. Assets can also
+// come from a mapped pack file: a table of contents followed by the files' bytes, handed out
+// as views into the mapping without copying. Mount before other threads start reading.
+class AssetVFS
+{
+public:
+	// Directory holding Resource_Files, with a trailing slash (empty for the working directory)
+	std::string Root;
+	// Constructor that resolves the root by looking for Resource_Files near the working directory and the executable
+	AssetVFS();
+
+	// Returns the instance every loader reads through
+	static AssetVFS& Default();
+
+	// Maps a pack file, its entries take precedence over loose files; returns false if it cannot be read
+	bool Mount(const std::string& packPath);
+	// Returns a view of a packed asset, false if no mounted pack holds it
+	bool Find(const std::string& name, std::string_view& data) const;
+	// Copies an asset from the pack or from disk into contents, returns false if it does not exist
+	bool Read(const std::string& name, std::string& contents) const;
+	// Returns the path on disk of an asset
+	std::string Resolve(const std::string& name) const;
+	// Lists every file below an asset directory, as asset names
+	std::vector<std::string> List(const std::string& directory) const;
+	// Unmaps every pack
+	void Delete();
+
+	// Writes the given assets into a pack file, returns false if any cannot be read or written
+	bool WritePack(const std::string& packPath, const std::vector<std::string>& names) const;
+
+private:
+	std::vector<MappedFile> packs;
+	std::unordered_map<std::string, std::string_view> entries;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef CALENDAR_QUEUE_CLASS_H
+#define CALENDAR_QUEUE_CLASS_H
+
+#include<cstddef>
+#include<cstdint>
+#include<vector>
+
+// Timed event handed out by CalendarQueue: what happens (kind) to whom (subject) when
+struct SimEvent
+{
+	double time;
+	uint32_t kind;
+	uint32_t subject;
+};
+
+// Priority queue of events ordered by time (R. Brown's calendar queue). Events are
+// sorted into buckets of Width time units each, like days on a calendar wrapping
+// every year; popping reads the bucket of the current day, so both push and pop cost
+// O(1) on average when the width matches the spacing of events. The bucket count
+// and width are re-estimated as the queue grows and shrinks. Events live in one
+// pooled arena linked by index, so once the pool has grown to the largest number of
+// events pending at once, pushing and popping allocate nothing. Events with equal
+// times come out in the order they were pushed.
+class CalendarQueue
+{
+public:
+	// Time units covered by each bucket
+	double Width;
+	// Constructor that starts empty with a few buckets of the given width
+	CalendarQueue(double width = 1.0);
+
+	// Grows the pool and buckets to hold events pending at once without allocating
+	void Reserve(size_t events);
+	// Adds an event
+	void Push(double time, uint32_t kind, uint32_t subject);
+	// Removes the earliest event into event, returns false if the queue is empty
+	bool Pop(SimEvent& event);
+	// Returns the time of the earliest event without removing it, the queue must not be empty
+	double PeekTime();
+	// Number of events pending
+	size_t Size() const;
+	// Removes every event, keeping the pool
+	void Clear();
+
+private:
+	struct Node
+	{
+		SimEvent event;
+		uint32_t next;
+	};
+	// Nodes link by pool index, 0xFFFFFFFF ends a list; free ones are linked from freeList
+	std::vector<Node> pool;
+	uint32_t freeList;
+	// First node of each bucket, each bucket sorted by time
+	std::vector<uint32_t> buckets;
+	size_t count;
+	// Bucket the next event is looked for in, and the day (time / Width) it is on
+	size_t current;
+	uint64_t currentDay;
+	// Bucket counts that trigger a resize
+	size_t growAt, shrinkAt;
+	// Set while a resize re-links nodes, so it does not resize again
+	bool resizing;
+
+	// Links a node into its bucket after any events with the same time
+	void Insert(uint32_t node);
+	// Moves current to the bucket holding the earliest node and returns it, count must not be 0
+	uint32_t FindFirst();
+	// Unlinks the earliest node, count must not be 0
+	uint32_t RemoveFirst();
+	// Moves current to the bucket and day of time
+	void SeekTo(double time);
+	// Changes the bucket count, re-estimating the width from the events at the front
+	void Resize(size_t bucketCount);
+};
+
+#endif
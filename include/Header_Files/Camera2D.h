@@ -0,0 +1,35 @@
+#ifndef CAMERA_2D_CLASS_H
+#define CAMERA_2D_CLASS_H
+
+#include<GLFW/glfw3.h>
+#include<glm/glm.hpp>
+
+// Pan and zoom on top of a fixed orthographic projection. At Zoom 1 and centred on the
+// projection's middle the view matrix is the identity, so the projection alone decides
+// what a fresh view shows. Arrow keys or WASD pan, Q/E (or -/+) zoom out and in.
+class Camera2D
+{
+public:
+	// World point shown in the middle of the window
+	glm::vec2 Center;
+	// Magnification relative to the projection
+	float Zoom;
+	// Constructor that shows everything the projection shows
+	Camera2D(const glm::mat4& projection);
+
+	// Projection the view is relative to, resets the camera
+	void Reset(const glm::mat4& projection);
+	// Moves the camera for the keys held down over seconds, returns true while any of them is held
+	bool Update(GLFWwindow* window, float seconds);
+	// Returns the view matrix
+	glm::mat4 View() const;
+	// Returns the world rectangle (min x, min y, max x, max y) visible through the projection and view
+	glm::vec4 VisibleRect() const;
+
+private:
+	glm::mat4 projection;
+	// Middle and size of what the projection shows with the identity view
+	glm::vec2 home, homeSize;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef DYNAMIC_ATTRIBUTE_BUFFER_CLASS_H
+#define DYNAMIC_ATTRIBUTE_BUFFER_CLASS_H
+
+#include<glad/glad.h>
+#include<map>
+#include<vector>
+
+// Buffer Object for data that changes a little at a time. Writes go to a CPU shadow
+// copy and the bytes they change are kept as a set of merged dirty ranges; Flush
+// uploads only those ranges with glBufferSubData, or the whole buffer in one call
+// once enough of it is dirty that separate uploads would cost more.
+class DynamicAttributeBuffer
+{
+public:
+	// Reference ID of the Buffer Object
+	GLuint ID;
+	// Bytes in use and bytes allocated on the GPU
+	GLsizeiptr Size, Capacity;
+	// Fraction of Size that, once dirty, is uploaded as a whole
+	float FullUploadRatio;
+	// Bytes and glBufferSubData/glBufferData calls sent by the last Flush
+	GLsizeiptr Uploaded;
+	GLuint Uploads;
+	// Constructor that generates a Buffer Object for target holding size bytes of data (may be NULL)
+	DynamicAttributeBuffer(GLenum target, const void* data, GLsizeiptr size);
+
+	// Copies size bytes to offset and marks them dirty, growing the buffer if they end past Size
+	void Write(GLintptr offset, const void* data, GLsizeiptr size);
+	// Like Write, but only marks the stride-sized records that differ from what is stored
+	void WriteChanged(GLintptr offset, const void* data, GLsizeiptr size, GLsizeiptr stride);
+	// Sets the bytes in use, kept bytes stay as they are
+	void Resize(GLsizeiptr size);
+	// Returns the shadow copy
+	const unsigned char* Data() const;
+	// Returns the number of bytes waiting for Flush
+	GLsizeiptr DirtyBytes() const;
+	// Uploads the dirty ranges, call on the GL thread before drawing
+	void Flush();
+	// Binds the Buffer Object
+	void Bind();
+	// Unbinds the Buffer Object
+	void Unbind();
+	// Deletes the Buffer Object
+	void Delete();
+
+private:
+	GLenum target;
+	std::vector<unsigned char> shadow;
+	// Dirty ranges by first byte, mapped to one past their last byte; never touching each other
+	std::map<GLintptr, GLintptr> dirty;
+	GLsizeiptr dirtyBytes;
+	// Set when the GPU storage must be allocated again before the next upload
+	bool reallocate;
+
+	// Adds [begin, end) to the dirty ranges, merging it with those it overlaps or touches
+	void MarkDirty(GLintptr begin, GLintptr end);
+};
+
+#endif
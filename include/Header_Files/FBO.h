@@ -0,0 +1,30 @@
+#ifndef FBO_CLASS_H
+#define FBO_CLASS_H
+
+#include<glad/glad.h>
+
+class FBO
+{
+public:
+	// Reference ID of the Framebuffer Object
+	GLuint ID;
+	// Texture the FBO renders its colors into
+	GLuint ColorTexture;
+	// Size of the color attachment in pixels
+	GLsizei Width, Height;
+	// Constructor that generates a Framebuffer Object with an RGBA color texture
+	FBO(GLsizei width, GLsizei height);
+
+	// Returns true if the driver accepted the attachments
+	bool IsComplete();
+	// Binds the FBO and sets the viewport to cover it
+	void Bind();
+	// Binds the default framebuffer again
+	void Unbind();
+	// Copies the color attachment into rgba (Width * Height * 4 bytes, bottom row first)
+	void ReadPixels(unsigned char* rgba);
+	// Deletes the FBO and its color texture
+	void Delete();
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef FILE_WATCHER_CLASS_H
+#define FILE_WATCHER_CLASS_H
+
+#include<functional>
+#include<mutex>
+#include<string>
+#include<thread>
+#include<unordered_map>
+#include<vector>
+
+// Watches directories for files that are written or moved in, on a background thread
+// using inotify. Changes are collected until the GL thread picks them up with Poll, so
+// reloads always happen on the thread that owns the GL objects. Other platforms build
+// a watcher that never reports anything.
+class FileWatcher
+{
+public:
+	// False when the platform or the system offers no file notifications
+	bool Supported;
+	// Constructor that starts the watcher thread, notify is called on that thread after every change
+	FileWatcher(std::function<void()> notify = std::function<void()>());
+
+	// Watches the directory at path, changes are reported as name + "/" + file name
+	bool Watch(const std::string& path, const std::string& name);
+	// Returns every changed file since the last call, each once, in the order they changed
+	std::vector<std::string> Poll();
+	// Stops the watcher thread
+	void Delete();
+
+private:
+	std::mutex mutex;
+	std::vector<std::string> changed;
+	std::function<void()> notify;
+#ifdef __linux__
+	int inotifyFd;
+	// Pipe written to by Delete to wake the thread up
+	int wakeFds[2];
+	std::thread thread;
+	// Reported name of each watched directory, by watch descriptor
+	std::unordered_map<int, std::string> directories;
+
+	// Body of the watcher thread
+	void WatchLoop();
+#endif
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef FRAME_CAPTURE_CLASS_H
+#define FRAME_CAPTURE_CLASS_H
+
+#include<glad/glad.h>
+#include<condition_variable>
+#include<deque>
+#include<fstream>
+#include<mutex>
+#include<string>
+#include<thread>
+#include<vector>
+
+// Reads frames back through a ring of pixel pack buffers so glReadPixels never waits
+// for the GPU. Each buffer is mapped a few frames after its readback was queued and
+// the pixels are handed to an encoder thread that writes PNG files or a Y4M video.
+class FrameCapture
+{
+public:
+	// Output of a recording
+	enum Format
+	{
+		PNG_SEQUENCE,
+		Y4M
+	};
+	// Size of the captured area in pixels
+	GLsizei Width, Height;
+	// True while every captured frame is recorded
+	bool Recording;
+	// Frames dropped because the encoder could not keep up
+	unsigned long Dropped;
+	// Constructor that generates ringSize pixel pack buffers of width * height RGBA pixels
+	FrameCapture(GLsizei width, GLsizei height, GLuint ringSize = 3);
+
+	// Starts recording into a directory of numbered PNGs or a single .y4m file
+	bool StartRecording(const std::string& path, Format format, int framesPerSecond);
+	// Stops recording once the frames already read back are written
+	void StopRecording();
+	// Saves the next captured frame as a PNG file
+	void Screenshot(const std::string& path);
+	// Queues a readback of framebuffer (0 for the back buffer), call after drawing and before swapping
+	void Capture(GLuint framebuffer);
+	// Writes every pending frame, stops the encoder and deletes the buffers
+	void Delete();
+
+private:
+	// Work for the encoder thread
+	enum JobKind
+	{
+		NO_JOB,
+		WRITE_PNG,
+		WRITE_Y4M_FRAME,
+		CLOSE_VIDEO,
+		QUIT
+	};
+	struct Job
+	{
+		JobKind kind;
+		// PNG file or Y4M video the pixels go to
+		std::string path;
+		// Requested through Screenshot, never dropped to bound the queue
+		bool screenshot;
+		int framesPerSecond;
+		std::vector<unsigned char> pixels;
+	};
+	// One pixel pack buffer of the ring
+	struct Slot
+	{
+		GLuint buffer;
+		GLsync fence;
+		Job job;
+	};
+
+	std::vector<Slot> slots;
+	GLuint nextSlot;
+	std::string pendingScreenshot;
+	Format format;
+	std::string recordPath;
+	int framesPerSecond;
+	unsigned long frameNumber;
+	// Jobs waiting for the encoder before recorded frames start being dropped
+	static const size_t MAX_QUEUED_JOBS = 8;
+
+	// Encoder thread and its queue
+	std::thread encoder;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<Job> jobs;
+	// Pixel vectors handed back by the encoder for reuse
+	std::vector<std::vector<unsigned char> > freePixels;
+	// Video currently written by the encoder thread
+	std::ofstream video;
+	std::string videoPath;
+
+	// Maps a finished slot, copies its pixels and queues them for the encoder
+	void Collect(Slot& slot, bool wait);
+	// Hands a job to the encoder thread, returns false if a recorded frame was dropped
+	bool Enqueue(Job& job);
+	// Body of the encoder thread
+	void EncodeLoop();
+	// Writes one job on the encoder thread
+	void Encode(Job& job);
+	// Appends one RGBA frame to the open video as 4:2:0 Y'CbCr
+	void WriteY4MFrame(const std::vector<unsigned char>& rgba);
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef FRAME_SCHEDULER_CLASS_H
+#define FRAME_SCHEDULER_CLASS_H
+
+#include<GLFW/glfw3.h>
+#include<atomic>
+
+// Decides when the window is redrawn. While nothing moves the thread sleeps in
+// glfwWaitEventsTimeout and only input, window changes or MarkDirty wake it up for a
+// frame; while Animating is set frames are paced to the target rate instead of
+// running flat out. Either way no more than TargetFrameRate frames are drawn per second.
+class FrameScheduler
+{
+public:
+	// Frames per second while animating, and the most drawn per second for input
+	double TargetFrameRate;
+	// Seconds between wake-ups while idle, 0 to sleep until an event arrives
+	double IdleTimeout;
+	// Set while something changes every frame (simulation, streaming, recording)
+	bool Animating;
+	// Frames drawn and wake-ups that drew nothing
+	unsigned long FramesDrawn, IdleWakeups;
+	// Constructor that installs the input callbacks that mark window dirty
+	FrameScheduler(GLFWwindow* window, double targetFrameRate = 60.0);
+
+	// Requests a redraw; safe from any thread, it wakes the GL thread if it is sleeping
+	void MarkDirty();
+	// Processes events until the next frame is due, returns false once the window should close
+	bool WaitForFrame();
+
+private:
+	GLFWwindow* window;
+	std::atomic<bool> dirty;
+	// When the last frame was started, in glfwGetTime seconds
+	double lastFrame;
+
+	// Input and window callbacks, all of them just mark the window dirty
+	static void OnKey(GLFWwindow* window, int key, int scancode, int action, int mods);
+	static void OnCursor(GLFWwindow* window, double x, double y);
+	static void OnMouseButton(GLFWwindow* window, int button, int action, int mods);
+	static void OnScroll(GLFWwindow* window, double x, double y);
+	static void OnResize(GLFWwindow* window, int width, int height);
+	static void OnRefresh(GLFWwindow* window);
+	static void OnFocus(GLFWwindow* window, int focused);
+};
+
+#endif
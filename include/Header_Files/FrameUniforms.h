@@ -0,0 +1,44 @@
+#ifndef FRAME_UNIFORMS_CLASS_H
+#define FRAME_UNIFORMS_CLASS_H
+
+#include<glad/glad.h>
+#include<glm/glm.hpp>
+#include<cstddef>
+
+// Name of the uniform block every shader declares to receive the per-frame data
+#define FRAME_UNIFORMS_BLOCK "FrameUniforms"
+// Uniform buffer binding point the FrameUniforms block of every Shader is bound to
+const GLuint FRAME_UNIFORMS_BINDING = 0;
+
+// Per-frame data shared by all shader programs, laid out to match the std140 block:
+// layout (std140) uniform FrameUniforms { mat4 projection; mat4 view; vec4 viewport; float time; };
+struct FrameUniformData
+{
+	glm::mat4 projection;
+	glm::mat4 view;
+	// x, y, width, height of the viewport in pixels
+	glm::vec4 viewport;
+	// Seconds since start-up
+	float time;
+	// std140 rounds the block size up to a multiple of vec4
+	float padding[3];
+};
+static_assert(sizeof(FrameUniformData) == 160, "FrameUniformData must match the std140 block size");
+
+class FrameUniforms
+{
+public:
+	// Reference ID of the Uniform Buffer Object
+	GLuint ID;
+	// Constructor that generates the Uniform Buffer Object and binds it to FRAME_UNIFORMS_BINDING
+	FrameUniforms();
+
+	// Uploads this frame's data, done once per frame for all programs
+	void Update(const FrameUniformData& data);
+	// Binds the buffer to FRAME_UNIFORMS_BINDING
+	void Bind();
+	// Deletes the Uniform Buffer Object
+	void Delete();
+};
+
+#endif
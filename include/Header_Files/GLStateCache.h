@@ -0,0 +1,65 @@
+#ifndef GL_STATE_CACHE_CLASS_H
+#define GL_STATE_CACHE_CLASS_H
+
+#include<glad/glad.h>
+#include<cstddef>
+
+// Shadow copy of the binding state of one OpenGL context. The wrapper classes bind
+// through it so calls that would not change anything never reach the driver.
+// Anything that binds behind its back must call Invalidate afterwards.
+class GLStateCache
+{
+public:
+	// Number of texture units tracked, binds on higher units always go to the driver
+	static const GLuint MAX_TEXTURE_UNITS = 32;
+	// Number of GL calls skipped because the state was already set
+	unsigned long Skipped;
+
+	// Constructor that starts with every binding unknown
+	GLStateCache();
+
+	// Returns the cache of the context current on this thread
+	static GLStateCache& Current();
+	// Makes cache the one used on this thread, call right after making its context current
+	static void MakeCurrent(GLStateCache* cache);
+
+	// Uses a Shader Program
+	void UseProgram(GLuint program);
+	// Binds a Vertex Array Object
+	void BindVertexArray(GLuint vao);
+	// Binds a buffer to a target
+	void BindBuffer(GLenum target, GLuint buffer);
+	// Binds a buffer to an indexed binding point, which also binds it to the generic target
+	void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+	// Selects the active texture unit (GL_TEXTURE0 + i)
+	void ActiveTexture(GLenum unit);
+	// Binds a texture to a target of the active texture unit
+	void BindTexture(GLenum target, GLuint texture);
+	// Makes unit active and binds a texture to it
+	void BindTextureUnit(GLuint unit, GLenum target, GLuint texture);
+
+	// Forget objects that are about to be deleted, GL unbinds them and may reuse the name
+	void ForgetProgram(GLuint program);
+	void ForgetVertexArray(GLuint vao);
+	void ForgetBuffer(GLuint buffer);
+	void ForgetTexture(GLuint texture);
+	// Marks every binding as unknown so the next bind of anything reaches the driver
+	void Invalidate();
+
+private:
+	// Buffer targets and texture targets with a slot in the cache
+	static const int BUFFER_TARGETS = 7;
+	static const int TEXTURE_TARGETS = 4;
+
+	GLuint program;
+	GLuint vertexArray;
+	GLuint buffers[BUFFER_TARGETS];
+	GLenum activeTexture;
+	GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_TARGETS];
+
+	// Maps a target enum to its slot, -1 for targets that are not cached
+	static int BufferSlot(GLenum target);
+	static int TextureSlot(GLenum target);
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef GARAGE_FILE_CLASS_H
+#define GARAGE_FILE_CLASS_H
+
+#include<string>
+#include<vector>
+#include"Header_Files/MappedFile.h"
+#include"Header_Files/GarageLayout.h"
+
+// Binary layout file, mapped into memory and read in place. A header and a table of
+// contents (each level's counts, bounds and name) are followed by one block per level
+// holding its columns back to back, every column aligned so it can be used straight
+// from the mapping. Opening only reads the table; a level's block is checked and its
+// pages touched the first time it is viewed, so opening a file of many levels is
+// instant and only the levels drawn cost I/O. Numbers are stored in the writer's byte
+// order, which the header records; files from a machine of the other order are refused.
+class GarageFile
+{
+public:
+	// Constructor that creates a closed file
+	GarageFile();
+
+	// Maps a layout file and reads its table of contents, returns false if it is not one
+	bool Open(const std::string& path);
+	// Returns true while a file is open
+	bool IsOpen() const;
+	// Number of levels in the file
+	int Levels() const;
+	// Returns the name of a level
+	const std::string& LevelName(int level) const;
+	// Returns the number of stalls on a level without reading its block
+	GLuint StallCount(int level) const;
+	// Points view at a level's columns inside the mapping, returns false if its block is damaged
+	bool View(int level, GarageLevelView& view);
+	// Copies a level into layout as a new level, returns false if its block is damaged
+	bool Load(int level, GarageLayout& layout);
+	// Replaces layout with one empty level per level of the file, named like them, without reading any block
+	void Outline(GarageLayout& layout) const;
+	// Copies a level into the same level of a layout made by Outline, returns false if its block is damaged
+	bool Fill(int level, GarageLayout& layout);
+	// Unmaps the file, earlier views become invalid
+	void Close();
+
+	// Returns true if path starts like a binary layout file
+	static bool Detect(const std::string& path);
+	// Writes every level of layout into a binary layout file, returns false if it cannot be written
+	static bool Write(const std::string& path, const GarageLayout& layout);
+	// Writes levels, wherever their columns are stored, into a binary layout file; returns false if it cannot be written
+	static bool Write(const std::string& path, const std::vector<std::string>& names, const std::vector<GarageLevelView>& views);
+
+private:
+	struct Level
+	{
+		std::string name;
+		uint64_t offset, size;
+		GLuint stallCount, aisleCount, rampCount, stringsSize;
+		glm::vec4 bounds;
+		// Set once the block has been checked against the file
+		bool checked;
+	};
+	MappedFile file;
+	std::vector<Level> levels;
+
+	// Copies the columns of view into a level of layout
+	static void Copy(const GarageLevelView& view, GarageLayout& layout, int level);
+};
+
+#endif
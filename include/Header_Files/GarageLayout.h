@@ -0,0 +1,132 @@
+#ifndef GARAGE_LAYOUT_CLASS_H
+#define GARAGE_LAYOUT_CLASS_H
+
+#include<glad/glad.h>
+#include<glm/glm.hpp>
+#include<cstdint>
+#include<string>
+#include<vector>
+#include"Header_Files/StallInstanceBuffer.h"
+
+// Kind of a stall, kept in the type column
+enum StallType
+{
+	STALL_STANDARD = 0,
+	STALL_COMPACT = 1,
+	STALL_ACCESSIBLE = 2,
+	STALL_EV = 3
+};
+// Arena offset of stalls without a label
+const GLuint NO_LABEL = 0xFFFFFFFFu;
+
+// Straight strip of driving surface: an aisle on its level, or a ramp to another level
+struct LayoutSegment
+{
+	glm::vec2 from, to;
+	float width;
+	// Level a ramp leads to, -1 for aisles
+	int toLevel;
+};
+
+// One floor of a garage, stored as columns: stall i is entry i of every column. The
+// placement, size, state and sprite columns are laid out like the stall shader's
+// per-instance attributes, so they are uploaded as they are (see StallColumnBuffer).
+struct GarageLevel
+{
+	// Arena offset of the level's name
+	GLuint name;
+	// x, y and angle in radians of every stall
+	std::vector<glm::vec3> placements;
+	// Width and depth of every stall
+	std::vector<glm::vec2> sizes;
+	// Occupancy state and atlas sprite (NO_SPRITE for none) of every stall
+	std::vector<GLuint> states;
+	std::vector<GLuint> sprites;
+	// StallType of every stall
+	std::vector<uint8_t> types;
+	// Arena offset of every stall's label, NO_LABEL for none
+	std::vector<GLuint> labels;
+	// Aisles on this level and ramps leaving it
+	std::vector<LayoutSegment> aisles;
+	std::vector<LayoutSegment> ramps;
+
+	// Number of stalls on the level
+	size_t StallCount() const;
+	// Bounds (min x, min y, max x, max y) of every stall, 0..1 for a level without stalls
+	glm::vec4 Bounds() const;
+};
+
+// Read-only view of one level's columns, wherever they are stored: the vectors of a
+// GarageLevel, or a level block of a mapped GarageFile used in place
+struct GarageLevelView
+{
+	GLuint stallCount;
+	const glm::vec3* placements;
+	const glm::vec2* sizes;
+	const GLuint* states;
+	const GLuint* sprites;
+	const uint8_t* types;
+	// Offsets into strings, NO_LABEL for none
+	const GLuint* labels;
+	GLuint aisleCount, rampCount;
+	const LayoutSegment* aisles;
+	const LayoutSegment* ramps;
+	// Zero-terminated strings the labels refer to
+	const char* strings;
+	GLuint stringsSize;
+	// Bounds (min x, min y, max x, max y) of every stall, as GarageLevel::Bounds
+	glm::vec4 bounds;
+
+	// Returns the label of a stall, "" for none
+	const char* Label(GLuint stall) const;
+};
+
+// Levels, stalls, aisles and ramps of a parking garage. Names and labels live in one
+// string arena and are referred to by offset, so a layout is a handful of large
+// allocations however many stalls it holds.
+class GarageLayout
+{
+public:
+	// Every level, bottom first
+	std::vector<GarageLevel> Levels;
+	// Constructor that creates an empty layout
+	GarageLayout();
+
+	// Adds a level and returns its index
+	int AddLevel(const std::string& name);
+	// Makes room for stalls more stalls on a level, so bulk loads grow every column once
+	void Reserve(int level, size_t stalls);
+	// Adds a stall to a level and returns its index there
+	GLuint AddStall(int level, const StallInstance& stall, uint8_t type = STALL_STANDARD, const std::string& label = "");
+	// Adds an aisle to a level
+	void AddAisle(int level, glm::vec2 from, glm::vec2 to, float width);
+	// Adds a ramp from a level to toLevel
+	void AddRamp(int level, glm::vec2 from, glm::vec2 to, float width, int toLevel);
+	// Sets the state of a stall
+	void SetState(int level, GLuint stall, GLuint state);
+	// Returns a stall as one record
+	StallInstance Stall(int level, GLuint stall) const;
+	// Replaces stalls with the records of every stall on a level
+	void Instances(int level, std::vector<StallInstance>& stalls) const;
+	// Number of stalls on every level together
+	size_t StallCount() const;
+	// Number of stalls in state on every level together
+	size_t CountState(GLuint state) const;
+	// Returns a name or label by its arena offset, "" for NO_LABEL
+	const char* String(GLuint offset) const;
+	// Copies a block of zero-terminated strings into the arena and returns the offset it starts at
+	GLuint AddStrings(const char* strings, size_t size);
+	// Returns a view of a level's columns, valid until the layout changes
+	GarageLevelView View(int level) const;
+	// Removes every level
+	void Clear();
+
+private:
+	// Every name and label, zero terminated, one after another
+	std::vector<char> arena;
+
+	// Copies text into the arena and returns its offset
+	GLuint Intern(const std::string& text);
+};
+
+#endif
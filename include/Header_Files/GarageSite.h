@@ -0,0 +1,47 @@
+#ifndef GARAGE_SITE_H
+#define GARAGE_SITE_H
+
+#include<glm/glm.hpp>
+#include<string>
+#include<vector>
+#include"Header_Files/GarageLayout.h"
+
+// Stall angles the generator tries, in degrees from the aisle
+const int GENERATOR_ANGLES = 3;
+const float GENERATOR_ANGLE_DEGREES[GENERATOR_ANGLES] = { 90.0f, 60.0f, 45.0f };
+
+// What a level is generated for: the footprint to fill and what must stay clear in it
+struct GarageSite
+{
+	// Outline of the level, any winding, no self intersections
+	std::vector<glm::vec2> footprint;
+	// Structural columns: squares of columnSize centred on columnOrigin + (i, j) * columnSpacing,
+	// no columns when the spacing is 0
+	glm::vec2 columnOrigin, columnSpacing;
+	float columnSize;
+	// Ramps, kept clear of stalls; toLevel is copied into the generated layout
+	std::vector<LayoutSegment> ramps;
+	// Entry and exit points, kept clear of stalls within entryClearance
+	std::vector<glm::vec2> entries;
+	float entryClearance;
+	// Size of one stall
+	float stallWidth, stallDepth;
+	// Aisle width needed by each of GENERATOR_ANGLES
+	float aisleWidths[GENERATOR_ANGLES];
+	// Constructor with common metric stall and aisle sizes
+	GarageSite();
+};
+
+// Reads a text site file for LayoutGenerator. Each line is one of:
+//   footprint x0 y0 x1 y1 x2 y2 ...    outline of the level, at least three points
+//   columns x y spacingX spacingY size grid of structural columns
+//   ramp x0 y0 x1 y1 width <level>     ramp to keep clear, leading to that level
+//   entry x y                          entry or exit point to keep clear
+//   clearance distance                 how far stalls stay from entries
+//   stall width depth                  size of one stall
+//   aisles width90 width60 width45     aisle width for each stall angle
+// Blank lines and lines starting with '#' are skipped; sizes not given keep GarageSite's defaults.
+// Returns false if the file cannot be opened, a line cannot be parsed or there is no footprint.
+bool load_garage_site(const std::string& path, GarageSite& site);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef IMAGE_WRITER_H
+#define IMAGE_WRITER_H
+
+#include<string>
+
+// Writes 8-bit pixels with 1 to 4 channels as a PNG file. Rows are read bottom-up when
+// flipVertically is set, which is the order glReadPixels returns them in.
+bool write_png(const std::string& path, const unsigned char* pixels, int width, int height, int channels, bool flipVertically);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef LAYOUT_FILE_H
+#define LAYOUT_FILE_H
+
+#include<string>
+#include<vector>
+#include"Header_Files/StallInstanceBuffer.h"
+#include"Header_Files/GarageLayout.h"
+
+// Reads a text layout file into a GarageLayout. Each line is a stall:
+//   x y angle width depth state [sprite [type [label]]]
+// where angle is in degrees, sprite is an optional atlas sprite index (-1 for none),
+// type a StallType and label at most 32 characters without spaces, or one of:
+//   level <name>                     starts a new level, stalls before it go to level "1"
+//   aisle x0 y0 x1 y1 width          adds an aisle to the current level
+//   ramp x0 y0 x1 y1 width <level>   adds a ramp to the level with that index
+// Blank lines and lines starting with '#' are skipped. Binary layout files (see GarageFile)
+// are recognised by their header and every level is copied in without parsing.
+// Returns false if the file cannot be opened, a line cannot be parsed or holds an unknown
+// stall type or an over-long label.
+bool load_garage_layout(const std::string& path, GarageLayout& layout);
+
+// Writes a GarageLayout as a text layout file that load_garage_layout reads back, for
+// diffing and hand edits. Returns false if the file cannot be written.
+bool save_garage_layout(const std::string& path, const GarageLayout& layout);
+// Same as save_garage_layout for levels given as views, so the levels of a mapped binary
+// file are written without copying them into a GarageLayout first.
+bool save_garage_levels(const std::string& path, const std::vector<std::string>& names, const std::vector<GarageLevelView>& views);
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef LAYOUT_GENERATOR_CLASS_H
+#define LAYOUT_GENERATOR_CLASS_H
+
+#include<glm/glm.hpp>
+#include<cstdint>
+#include<string>
+#include<unordered_map>
+#include<vector>
+#include"Header_Files/GarageLayout.h"
+#include"Header_Files/GarageSite.h"
+#include"Header_Files/ThreadPool.h"
+
+// Fills a site with rows of stalls along double-loaded aisles, searching for the most
+// stalls with simulated annealing. A candidate is an aisle direction (0, 90 degrees and
+// the footprint's edge directions), an offset of the first row, and per module (two
+// rows facing one aisle) a stall angle and a shift along the rows. Independent chains
+// run on the pool, one per direction and seed, each seeded from Seed and its index, so
+// the result does not depend on thread timing. A move changes one gene, and only the
+// modules it moves are scored again; module scores are memoised per chain, so chains
+// revisiting a placement cost a lookup.
+class LayoutGenerator
+{
+public:
+	// Annealing steps per chain, and chains per aisle direction
+	int Iterations;
+	int ChainsPerDirection;
+	// Seed the chains' seeds are derived from
+	uint32_t Seed;
+	// Annealing temperature in stalls at the first and last step
+	float StartTemperature, EndTemperature;
+	// Offsets and shifts are multiples of this length
+	float Step;
+	// Stalls in the best layout found, and candidates scored by the last Generate
+	int BestStalls;
+	long long Candidates;
+	// Constructor with defaults that suit a level of a few hundred stalls
+	LayoutGenerator();
+
+	// Searches the site on the pool's workers, returns false if the footprint has no area
+	bool Generate(const GarageSite& site, ThreadPool& pool);
+	// Adds the best layout found as a new level of layout, with its aisles and the site's ramps
+	int Build(GarageLayout& layout, const std::string& levelName) const;
+
+private:
+	// Stall angle and shift along the rows of one module
+	struct Gene
+	{
+		uint8_t angle;
+		uint16_t shift;
+	};
+	// Rows run along u and modules stack along v; the footprint spans [min, max] on each
+	struct Frame
+	{
+		glm::vec2 u, v;
+		float minU, maxU, minV, maxV;
+	};
+	struct Candidate
+	{
+		int frame;
+		int offset;
+		std::vector<Gene> genes;
+		int stalls;
+	};
+	struct Chain
+	{
+		Candidate current;
+		// Start of every module along v and its score
+		std::vector<float> starts;
+		std::vector<int> scores;
+		std::unordered_map<uint64_t, int> memo;
+		Candidate best;
+		long long candidates;
+	};
+
+	GarageSite site;
+	std::vector<Frame> frames;
+	// Corners of every ramp and entry stalls must keep clear of, four per quad
+	std::vector<glm::vec2> keepOuts;
+	Candidate best;
+
+	// Runs one annealing chain from its seed
+	void RunChain(Chain& chain, uint32_t seed) const;
+	// Scores modules first onwards, reusing those that neither moved nor changed
+	void Rescore(Chain& chain, size_t first) const;
+	// Depth across the aisle of one row of stalls at angle, and of a whole module
+	float RowDepth(int angle) const;
+	float ModulePitch(int angle) const;
+	// Places the stalls of a module starting at start along v; appends them to stalls if it is not NULL
+	int PlaceModule(const Frame& frame, float start, Gene gene, std::vector<StallInstance>* stalls, LayoutSegment* aisle) const;
+	// Returns true if a stall with these corners fits the site
+	bool StallFits(const glm::vec2 corners[4]) const;
+};
+
+#endif
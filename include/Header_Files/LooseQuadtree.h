@@ -0,0 +1,70 @@
+#ifndef LOOSE_QUADTREE_CLASS_H
+#define LOOSE_QUADTREE_CLASS_H
+
+#include<glad/glad.h>
+#include<glm/glm.hpp>
+#include<vector>
+
+// Loose quadtree over axis-aligned bounds (min x, min y, max x, max y) of layout elements.
+// Every node's bounds are its cell grown by half a cell on each side, so an element goes
+// straight into the node picked by its size and centre: inserting never splits nodes,
+// and moving an element that stays in its node only rewrites its bounds. Queries visit
+// only the nodes overlapping the rectangle and skip empty subtrees.
+class LooseQuadtree
+{
+public:
+	// Constructor that covers the world from worldMin to worldMax with at most maxDepth levels below the root
+	LooseQuadtree(glm::vec2 worldMin, glm::vec2 worldMax, int maxDepth = 8);
+
+	// Adds element id (any index below a few million) with the given bounds
+	void Insert(GLuint id, const glm::vec4& bounds);
+	// Moves element id to new bounds, inserting it if it is not in the tree yet
+	void Update(GLuint id, const glm::vec4& bounds);
+	// Removes element id
+	void Remove(GLuint id);
+	// Appends the id of every element whose bounds overlap rect
+	void Query(const glm::vec4& rect, std::vector<GLuint>& ids) const;
+	// Number of elements in the tree
+	size_t Size() const;
+	// Removes every element
+	void Clear();
+
+private:
+	struct Node
+	{
+		// Cell this node covers, its loose bounds are twice as large
+		glm::vec2 center;
+		float halfSize;
+		// First child, the four children are stored next to each other; -1 for none yet
+		int firstChild;
+		int parent;
+		// Elements in this node and in the whole subtree
+		std::vector<GLuint> items;
+		size_t subtreeCount;
+	};
+	struct Item
+	{
+		glm::vec4 bounds;
+		int node;
+		// Position in the node's item list
+		GLuint slot;
+	};
+
+	glm::vec2 worldMin, worldMax;
+	int maxDepth;
+	std::vector<Node> nodes;
+	// Indexed by element id, node is -1 for ids not in the tree
+	std::vector<Item> items;
+	size_t count;
+
+	// Returns the node an element with bounds belongs in, creating nodes on the way
+	int Place(const glm::vec4& bounds);
+	// Adds id to node and to the counts of its ancestors
+	void Link(GLuint id, int node);
+	// Takes id out of its node and the counts of its ancestors
+	void Unlink(GLuint id);
+	// Appends the overlapping elements of a subtree
+	void QueryNode(int node, const glm::vec4& rect, std::vector<GLuint>& ids) const;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_CLASS_H
+#define MAPPED_FILE_CLASS_H
+
+#include<cstddef>
+#include<string>
+
+// Read-only memory mapping of a whole file. Like the GL wrappers it is a plain handle:
+// copies share the mapping and Close must be called exactly once.
+class MappedFile
+{
+public:
+	// Start of the mapped bytes, NULL when nothing is mapped
+	const unsigned char* Data;
+	// Size of the file in bytes
+	size_t Size;
+	// Constructor that creates an empty handle
+	MappedFile();
+
+	// Maps path into memory, returns false if it cannot be opened or is empty
+	bool Open(const std::string& path);
+	// Returns true while a file is mapped
+	bool IsOpen() const;
+	// Unmaps the file
+	void Close();
+
+private:
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef OCCUPANCY_SIMULATOR_CLASS_H
+#define OCCUPANCY_SIMULATOR_CLASS_H
+
+#include<glad/glad.h>
+#include<cstdint>
+#include<functional>
+#include<vector>
+#include"Header_Files/GarageLayout.h"
+#include"Header_Files/CalendarQueue.h"
+
+// Event-driven simulation of a garage's occupancy, in minutes from midnight on a Monday.
+// Vehicles arrive as a Poisson process whose rate follows the hour of the day (scaled at
+// weekends), take a free stall, stay for a log-normally distributed dwell and leave;
+// vehicles finding no stall are turned away. Vehicles with an accessible permit prefer
+// accessible stalls, the others only use standard ones; reserved stalls are never
+// assigned. Events run from a CalendarQueue whose pool holds one departure per stall
+// plus the next arrival and sample, so the event loop allocates nothing.
+class OccupancySimulator
+{
+public:
+	// Vehicles arriving per hour, for each hour of the day
+	float HourlyArrivals[24];
+	// Arrival rate on Saturdays and Sundays relative to weekdays
+	float WeekendFactor;
+	// Mean dwell in minutes, and the spread (sigma of its logarithm)
+	float DwellMinutes, DwellSpread;
+	// Share of vehicles with an accessible permit
+	float AccessibleShare;
+	// Seed of the random number sequence, the same seed gives the same run
+	uint32_t Seed;
+	// Called whenever a stall changes state (level, stall on the level, new state), may be empty
+	std::function<void(int, GLuint, GLuint)> OnStateChange;
+
+	// Vehicles arrived, parked and turned away, and the most stalls occupied at once
+	uint64_t Arrivals, Parked, TurnedAway;
+	GLuint PeakOccupied;
+	// Stall-minutes occupied, and the occupied share sampled at each hour of the day summed over days
+	double OccupiedMinutes;
+	double HourOccupancy[24];
+	uint64_t HourSamples[24];
+	// Constructor with a weekday profile for a city-centre garage of about 500 stalls
+	OccupancySimulator();
+
+	// Takes the stalls of every level of layout, all free, and starts at minute 0
+	void Reset(const GarageLayout& layout);
+	// Runs every event up to and including minute
+	void RunUntil(double minute);
+	// Current minute of the simulation
+	double Now() const;
+	// Number of stalls occupied now, and of stalls vehicles can be assigned
+	GLuint Occupied() const;
+	GLuint Capacity() const;
+	// Average share of the assignable stalls occupied so far
+	double AverageOccupancy() const;
+
+private:
+	// What an event does; its subject is the stall for departures
+	enum EventKind
+	{
+		EVENT_ARRIVAL,
+		EVENT_DEPARTURE,
+		EVENT_SAMPLE
+	};
+	struct Stall
+	{
+		int level;
+		GLuint stall;
+		// State the stall returns to when its vehicle leaves
+		GLuint freeState;
+	};
+	std::vector<Stall> stalls;
+	// Free stalls by kind, used as stacks
+	std::vector<GLuint> freeStandard, freeAccessible;
+	CalendarQueue queue;
+	uint64_t random;
+	double now;
+	GLuint occupied;
+
+	// Returns the time of the next arrival after time, following the hourly rates; negative if none come
+	double NextArrival(double time);
+	// Handles one event
+	void Dispatch(const SimEvent& event);
+	// Reports a new state for a stall
+	void ReportState(GLuint stall, GLuint state);
+};
+
+#endif
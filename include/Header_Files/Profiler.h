@@ -0,0 +1,120 @@
+#ifndef PROFILER_CLASS_H
+#define PROFILER_CLASS_H
+
+#include<glad/glad.h>
+#include<chrono>
+#include<cstdint>
+#include<deque>
+#include<mutex>
+#include<ostream>
+#include<string>
+#include<thread>
+#include<unordered_map>
+#include<vector>
+
+// Frame profiler with CPU zones timed on the calling thread and GPU zones timed with
+// GL_TIMESTAMP queries. Query results are read a few frames after they were issued,
+// so profiling never waits for the GPU. Every zone is added to per-name statistics
+// and to a bounded event log that WriteTrace saves as Chrome trace_event JSON.
+class Profiler
+{
+public:
+	// Running statistics of one zone name, in milliseconds
+	struct ZoneStats
+	{
+		unsigned long Count;
+		double Total, Min, Max, Last;
+	};
+	// Frames a GPU zone's queries are given before they are read back
+	static const GLuint FRAME_LATENCY = 4;
+	// Events kept for the trace, older ones are dropped
+	static const size_t MAX_TRACE_EVENTS = 1 << 18;
+	// Constructor that calibrates the GPU clock against the CPU clock (needs a current context)
+	Profiler();
+
+	// Reads back finished GPU zones, call at the start of every frame on the GL thread
+	void BeginFrame();
+	// Closes the frame's GPU zones, call at the end of every frame on the GL thread
+	void EndFrame();
+	// Starts a CPU zone on the calling thread, name must outlive the profiler
+	void BeginCPU(const char* name);
+	// Ends the calling thread's innermost CPU zone
+	void EndCPU();
+	// Starts a GPU zone around the commands issued until EndGPU, on the GL thread
+	void BeginGPU(const char* name);
+	// Ends the innermost GPU zone
+	void EndGPU();
+
+	// Returns the statistics of every zone name, CPU zones as "cpu:name" and GPU zones as "gpu:name"
+	std::unordered_map<std::string, ZoneStats> Stats() const;
+	// Prints the statistics as a table
+	void Report(std::ostream& out) const;
+	// Saves the recorded events as Chrome trace_event JSON, returns false if the file cannot be written
+	bool WriteTrace(const std::string& path) const;
+	// Deletes the query objects
+	void Delete();
+
+private:
+	// A finished zone
+	struct Event
+	{
+		const char* name;
+		bool gpu;
+		unsigned int thread;
+		int64_t start;
+		int64_t duration;
+	};
+	// A GPU zone waiting for its queries
+	struct GPUZone
+	{
+		const char* name;
+		GLuint begin, end;
+	};
+	// An open CPU zone
+	struct OpenZone
+	{
+		const char* name;
+		int64_t start;
+	};
+
+	std::chrono::steady_clock::time_point origin;
+	// GPU timestamp at origin, in nanoseconds
+	int64_t gpuOrigin;
+	// Query objects ready for reuse
+	std::vector<GLuint> freeQueries;
+	// GPU zones of the last frames, oldest first, one list per frame
+	std::deque<std::vector<GPUZone> > pendingFrames;
+	std::vector<GPUZone> currentFrame;
+	std::vector<size_t> openGPU;
+	// Open CPU zones of each thread, and a small number for each thread in the trace
+	std::unordered_map<std::thread::id, std::vector<OpenZone> > openCPU;
+	std::unordered_map<std::thread::id, unsigned int> threadNumbers;
+
+	mutable std::mutex mutex;
+	std::deque<Event> events;
+	std::unordered_map<std::string, ZoneStats> stats;
+
+	// Nanoseconds since origin on the CPU clock
+	int64_t Now() const;
+	// Returns a query object from the free list or a new one
+	GLuint AcquireQuery();
+	// Reads back the oldest pending frame, waiting for it only if wait is set; returns false if it is not ready
+	bool Resolve(bool wait);
+	// Adds a finished zone to the statistics and the trace, mutex must be held
+	void Record(const char* name, bool gpu, unsigned int thread, int64_t start, int64_t duration);
+};
+
+// Times the enclosing scope as a CPU zone
+class ProfileScope
+{
+public:
+	// Constructor that starts the zone
+	ProfileScope(Profiler& profiler, const char* name) : profiler(profiler) { profiler.BeginCPU(name); }
+	// Destructor that ends the zone
+	~ProfileScope() { profiler.EndCPU(); }
+
+private:
+	Profiler& profiler;
+};
+
+#endif
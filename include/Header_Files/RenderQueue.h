@@ -0,0 +1,72 @@
+#ifndef RENDER_QUEUE_CLASS_H
+#define RENDER_QUEUE_CLASS_H
+
+#include<glad/glad.h>
+#include<cstdint>
+#include<mutex>
+#include<vector>
+#include"Header_Files/GLStateCache.h"
+
+// A single recorded draw. Key decides the replay order, the rest is the state and
+// the draw call itself, so recording does not need a GL context.
+struct RenderCommand
+{
+	// Sort key built with RenderQueue::MakeKey
+	uint64_t Key;
+	// Shader Program, Vertex Array Object and 2D texture on unit 0 (0 for none)
+	GLuint Program;
+	GLuint VAO;
+	GLuint Texture;
+	// Primitive type, e.g. GL_TRIANGLES
+	GLenum Mode;
+	// Number of indices drawn from the VAO's element buffer
+	GLsizei Count;
+	// Byte offset of the first index in the element buffer
+	GLintptr Offset;
+	// Number of instances, RenderQueue::NOT_INSTANCED for a plain glDrawElements;
+	// instanced draws of 0 instances are skipped
+	GLsizei InstanceCount;
+};
+
+// Draw commands can be pushed from any thread; the GL thread sorts them by key and
+// replays them, merging neighbouring draws that share all their state.
+class RenderQueue
+{
+public:
+	// Instance count of commands that are not instanced
+	static const GLsizei NOT_INSTANCED = -1;
+	// Number of commands replayed and draw calls issued by the last Execute
+	size_t Executed;
+	size_t DrawCalls;
+	// Constructor that creates an empty queue
+	RenderQueue();
+
+	// Builds a sort key: layer first, then program, texture and VAO, then a free order byte
+	static uint64_t MakeKey(uint8_t layer, GLuint program, GLuint texture, GLuint vao, uint8_t order = 0);
+	// Builds a command drawing count indices of the VAO's element buffer
+	static RenderCommand Indexed(uint8_t layer, GLuint program, GLuint texture, GLuint vao, GLsizei count, GLintptr offset = 0, GLsizei instanceCount = NOT_INSTANCED);
+
+	// Adds one command, safe to call from any thread
+	void Push(const RenderCommand& command);
+	// Adds a batch of commands recorded locally, taking the lock only once
+	void Submit(const std::vector<RenderCommand>& commands);
+	// Sorts and replays every pushed command, must be called on the GL thread
+	void Execute(GLStateCache& state);
+
+private:
+	std::mutex mutex;
+	// Commands pushed since the last Execute
+	std::vector<RenderCommand> pending;
+	// Reused between frames so Execute does not allocate once warmed up
+	std::vector<RenderCommand> commands;
+	std::vector<RenderCommand> sorted;
+	std::vector<uint64_t> keys;
+	std::vector<uint64_t> keysScratch;
+	std::vector<uint32_t> order;
+	std::vector<uint32_t> orderScratch;
+
+	// Stable LSD radix sort of commands by key into sorted
+	void Sort();
+};
+
+#endif
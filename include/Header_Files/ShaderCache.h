@@ -0,0 +1,37 @@
+#ifndef SHADER_CACHE_CLASS_H
+#define SHADER_CACHE_CLASS_H
+
+#include<glad/glad.h>
+#include<cstdint>
+#include<string>
+#include<vector>
+
+// On-disk cache of linked program binaries (ARB_get_program_binary). Entries are keyed
+// by a hash of the shader sources, their defines and the driver's vendor, renderer and
+// version strings, so a driver update simply misses instead of loading a stale binary.
+class ShaderCache
+{
+public:
+	// Directory the binaries are written to
+	std::string Directory;
+	// False when the driver offers no binary formats, Load and Store then do nothing
+	bool Supported;
+	// Constructor that uses directory for the cache, creating it if needed (needs a current context)
+	ShaderCache(const std::string& directory);
+
+	// Hashes every source and define string together with the driver identity
+	uint64_t Key(const std::vector<std::string>& parts) const;
+	// Creates a program from the cached binary for key, returns 0 if it is missing or rejected
+	GLuint Load(uint64_t key) const;
+	// Saves the binary of a successfully linked program under key
+	bool Store(uint64_t key, GLuint program) const;
+
+private:
+	// Vendor, renderer and version of the driver the binaries belong to
+	std::string driver;
+
+	// Returns the cache file for a key
+	std::string EntryPath(uint64_t key) const;
+};
+
+#endif
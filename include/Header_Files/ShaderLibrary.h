@@ -0,0 +1,82 @@
+#ifndef SHADER_LIBRARY_CLASS_H
+#define SHADER_LIBRARY_CLASS_H
+
+#include<glad/glad.h>
+#include<cstdint>
+#include<string>
+#include<unordered_map>
+#include<vector>
+#include"Header_Files/shaderClass.h"
+#include"Header_Files/ShaderCache.h"
+
+// Builds shader permutations from one vertex/fragment source pair plus a set of
+// optional defines. #include "file" lines are resolved once per file, and every
+// requested permutation is compiled and linked together in Build, which issues all
+// compiles and links before querying any status so the driver can overlap the work.
+// Permutations are looked up by program index and define bitmask, and can be rebuilt
+// in place when one of their files changes.
+class ShaderLibrary
+{
+public:
+	// Constructor that creates an empty library, cache may be NULL
+	ShaderLibrary(ShaderCache* cache = NULL);
+
+	// Registers a program and its optional defines, bit i of a mask enables defines[i]; returns the program index
+	GLuint Add(const char* vertexFile, const char* fragmentFile, const std::vector<std::string>& defines = std::vector<std::string>());
+	// Queues a permutation to be built by the next Build
+	void Request(GLuint program, GLuint mask = 0);
+	// Compiles and links every queued permutation, returns false if any of them failed
+	bool Build();
+	// Returns a built permutation, NULL if it was never requested or failed to build
+	Shader* Get(GLuint program, GLuint mask = 0);
+	// Rebuilds every permutation that reads file, directly or through #include, and swaps in
+	// the new programs; a permutation that fails keeps its old program. Returns true if any
+	// program was replaced, their uniforms are then back to their defaults
+	bool Reload(const std::string& file);
+	// Deletes every permutation
+	void Delete();
+
+	// Compact lookup key of a permutation
+	static uint64_t PermutationKey(GLuint program, GLuint mask);
+
+private:
+	// Source files and optional defines of a registered program
+	struct ProgramSource
+	{
+		std::string vertexFile;
+		std::string fragmentFile;
+		std::vector<std::string> defines;
+	};
+	// A permutation between issuing its compiles and checking the result
+	struct PendingBuild
+	{
+		uint64_t key;
+		uint64_t cacheKey;
+		GLuint vertexShader;
+		GLuint fragmentShader;
+		GLuint program;
+	};
+
+	ShaderCache* cache;
+	std::vector<ProgramSource> programs;
+	std::vector<uint64_t> requested;
+	std::unordered_map<uint64_t, Shader> permutations;
+	// Files with their #includes already resolved, and the files each of them includes
+	std::unordered_map<std::string, std::string> resolved;
+	std::unordered_map<std::string, std::vector<std::string> > includes;
+
+	// Compiles and links the given permutations, replacing those already built; returns false if any failed
+	bool Compile(const std::vector<uint64_t>& keys, bool& replaced);
+	// Stores a linked program as a permutation, deleting the program it replaces
+	void Replace(uint64_t key, GLuint program, bool& replaced);
+	// Returns a file with its #includes resolved, reading each file only once
+	const std::string& Resolve(const std::string& file, int depth = 0);
+	// Returns true if file is source or is included by it, directly or not
+	bool DependsOn(const std::string& source, const std::string& file, int depth = 0) const;
+	// Inserts a #define for every bit of mask right after the #version line
+	static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines, GLuint mask);
+	// Prints the info log of a shader that failed to compile
+	static void ReportCompile(GLuint shader, const std::string& file);
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef STALL_COLUMN_BUFFER_CLASS_H
+#define STALL_COLUMN_BUFFER_CLASS_H
+
+#include<glad/glad.h>
+#include"Header_Files/VAO.h"
+#include"Header_Files/GarageLayout.h"
+#include"Header_Files/DynamicAttributeBuffer.h"
+
+// Per-instance stall attributes read straight from the columns of a level, one
+// buffer per column. Uploading a level again only sends the parts of each column
+// that changed, so an occupancy change touches a few bytes of the state column.
+class StallColumnBuffer
+{
+public:
+	// One buffer per instance attribute column
+	DynamicAttributeBuffer Placements, Sizes, States, Sprites;
+	// Number of stalls uploaded
+	GLsizei Count;
+	// Constructor that generates empty column buffers
+	StallColumnBuffer();
+
+	// Uploads the columns of a level, only sending what differs from the last upload
+	void Upload(const GarageLevelView& level);
+	// Links the columns to the VAO with the attribute layout of StallInstanceBuffer::LinkAttribs
+	void LinkAttribs(VAO& VAO, GLuint firstLayout);
+	// Deletes the column buffers
+	void Delete();
+};
+
+#endif
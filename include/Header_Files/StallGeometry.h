@@ -0,0 +1,34 @@
+#ifndef STALL_GEOMETRY_H
+#define STALL_GEOMETRY_H
+
+#include<glad/glad.h>
+#include<glm/glm.hpp>
+
+// A row of identical stalls standing side by side, as laid along an aisle
+struct StallRow
+{
+	// Centre of the first stall
+	glm::vec2 origin;
+	// Unit direction the row runs in
+	glm::vec2 direction;
+	// Size of one stall
+	GLfloat width, depth;
+	// Angle in radians between the row and the stalls' depth, pi/2 for right-angled stalls;
+	// angles past pi/2 lean the other way, as on the far side of a one-way aisle
+	GLfloat angle;
+	// Number of stalls
+	GLuint count;
+};
+
+// Floats per vertex (x, y, z, u, v, the layout of the quad VBO in main) and per stall
+const int STALL_VERTEX_FLOATS = 5;
+const int STALL_ROW_FLOATS = 4 * STALL_VERTEX_FLOATS;
+
+// Writes the four corners of every stall of a row, STALL_ROW_FLOATS floats per stall, in
+// the order of the quad in main: lower left, lower right, upper left, upper right, with
+// UVs from 0 to 1. Built with GLM_FORCE_INTRINSICS, 8 stalls are done per step on AVX2
+// and 4 on SSE2, through glm's SIMD platform layer; the remainder and other targets use
+// the scalar loop.
+void stall_row_vertices(const StallRow& row, GLfloat* vertices);
+
+#endif
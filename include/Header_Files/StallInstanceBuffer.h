@@ -0,0 +1,61 @@
+#ifndef STALL_INSTANCE_BUFFER_CLASS_H
+#define STALL_INSTANCE_BUFFER_CLASS_H
+
+#include<glad/glad.h>
+#include<cstddef>
+#include"Header_Files/VAO.h"
+#include"Header_Files/TextureAtlas.h"
+#include"Header_Files/DynamicAttributeBuffer.h"
+
+// Compact per-stall record, one per instance of the stall quad
+struct StallInstance
+{
+	// Centre of the stall in layout coordinates
+	GLfloat x, y;
+	// Rotation of the stall around its centre in radians
+	GLfloat angle;
+	// Width and depth of the stall in layout coordinates
+	GLfloat width, depth;
+	// State of the stall, used by the shader as a color index
+	GLuint state;
+	// Index of the atlas sprite painted on the stall, NO_SPRITE for none
+	GLuint sprite;
+};
+
+// Instance buffer of StallInstance records. Updates only upload the records that
+// changed, so occupancy changes to a few stalls cost a few small uploads.
+class StallInstanceBuffer
+{
+public:
+	// Shadow copy and dirty ranges of the instance Vertex Buffer Object
+	DynamicAttributeBuffer Storage;
+	// Reference ID of the instance Vertex Buffer Object
+	GLuint ID;
+	// Number of stalls currently stored in the buffer
+	GLsizei Count;
+	// Number of stalls the buffer has room for
+	GLsizei Capacity;
+	// Constructor that generates an instance buffer and uploads the stalls to it
+	StallInstanceBuffer(const StallInstance* instances, GLsizei count);
+
+	// Replaces the stored stalls, uploading only the records that differ from the stored ones
+	void Update(const StallInstance* instances, GLsizei count);
+	// Replaces a single stored stall, uploaded by the next Update or Flush
+	void Set(GLsizei index, const StallInstance& instance);
+	// Uploads the records changed by Set
+	void Flush();
+	// Links the per-instance attributes to the VAO starting at a certain layout
+	void LinkAttribs(VAO& VAO, GLuint firstLayout);
+	// Links StallInstance attributes stored at offset in any buffer, e.g. a StreamingVBO region
+	static void LinkAttribs(VAO& VAO, GLuint buffer, GLintptr offset, GLuint firstLayout);
+	// Draws every stored stall with a single instanced draw call (VAO must be bound)
+	void Draw(GLsizei indexCount);
+	// Binds the instance buffer
+	void Bind();
+	// Unbinds the instance buffer
+	void Unbind();
+	// Deletes the instance buffer
+	void Delete();
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef STALL_LOD_CLASS_H
+#define STALL_LOD_CLASS_H
+
+#include<glad/glad.h>
+#include<glm/glm.hpp>
+#include<vector>
+#include"Header_Files/StallInstanceBuffer.h"
+#include"Header_Files/LooseQuadtree.h"
+
+// Levels of detail over a layout. Level 0 holds the stalls themselves, every level
+// above it groups the stalls into grid cells twice as large as the level below and
+// stands each group in with one aggregate: a StallInstance covering the group's
+// bounds whose state is the percentage of stalls taken (occupied or reserved).
+// Each level has its own spatial index, and the level drawn is the finest one whose
+// elements still cover MinPixels on screen, so zooming out keeps the count in view flat.
+class StallLOD
+{
+public:
+	// Smallest size in pixels an element may be drawn at before a coarser level is used
+	float MinPixels;
+	// Constructor that starts without levels
+	StallLOD(float minPixels = 4.0f);
+
+	// Rebuilds every level from the stalls
+	void Build(const std::vector<StallInstance>& stalls);
+	// Number of levels, 1 (the stalls alone) for small layouts
+	int Levels() const;
+	// Returns the level to draw at pixelsPerUnit screen pixels per layout unit
+	int SelectLevel(float pixelsPerUnit) const;
+	// Appends the elements of level overlapping rect (min x, min y, max x, max y)
+	void Query(int level, const glm::vec4& rect, std::vector<StallInstance>& elements) const;
+	// Sets the state of a stall and updates the aggregates above it; changed[k] receives the bounds
+	// of the element that changed on level k, or an empty rectangle, and stays empty if nothing did
+	void SetState(GLuint stall, GLuint state, std::vector<glm::vec4>& changed);
+	// Range of pixels per unit [minimum, maximum) that SelectLevel picks level for
+	void PixelsPerUnitRange(int level, float& minimum, float& maximum) const;
+
+private:
+	// Most levels above the stalls
+	static const int MAX_AGGREGATE_LEVELS = 16;
+	struct Level
+	{
+		std::vector<StallInstance> elements;
+		LooseQuadtree tree;
+		// Typical width of an element in layout units
+		float size;
+		// Bounds of every element, and how many stalls it stands for and how many of those are taken
+		std::vector<glm::vec4> bounds;
+		std::vector<GLuint> totals, taken;
+		// Element of the level above each element is grouped into
+		std::vector<GLuint> parents;
+		Level(glm::vec2 worldMin, glm::vec2 worldMax) : tree(worldMin, worldMax), size(0.0f) {}
+	};
+	std::vector<Level> levels;
+	// Reused by Query
+	mutable std::vector<GLuint> ids;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef STREAMING_VBO_CLASS_H
+#define STREAMING_VBO_CLASS_H
+
+#include<glad/glad.h>
+#include<cstddef>
+#include<vector>
+
+// Vertex Buffer Object for data that changes every frame. The buffer is split into
+// regionCount frame regions used as a ring; a region is only written again once the
+// fence placed after the frame that last used it has signalled.
+class StreamingVBO
+{
+public:
+	// Reference ID of the Vertex Buffer Object
+	GLuint ID;
+	// Size in bytes of a single frame region
+	GLsizeiptr RegionSize;
+	// Number of frame regions in the ring
+	GLuint RegionCount;
+	// Index of the region written this frame
+	GLuint Region;
+	// Constructor that generates a Vertex Buffer Object with regionCount regions of regionSize bytes
+	StreamingVBO(GLsizeiptr regionSize, GLuint regionCount = 3);
+
+	// Waits until the current region is free and maps it for writing
+	void BeginFrame();
+	// Sub-allocates size bytes from the current region, returns NULL if the region is full
+	void* Allocate(GLsizeiptr size, GLintptr& offset);
+	// Flushes the written bytes and unmaps the region, must be called before drawing
+	void Unmap();
+	// Fences the current region after this frame's draws and moves to the next one
+	void EndFrame();
+	// Binds the VBO
+	void Bind();
+	// Unbinds the VBO
+	void Unbind();
+	// Deletes the VBO and its fences
+	void Delete();
+
+private:
+	// Fence for each region, 0 when the region has never been used
+	std::vector<GLsync> fences;
+	// Write pointer to the mapped region, NULL when unmapped
+	char* mapped;
+	// Bytes already handed out from the current region
+	GLsizeiptr used;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TEXTURE_ATLAS_CLASS_H
+#define TEXTURE_ATLAS_CLASS_H
+
+#include<glad/glad.h>
+#include<glm/glm.hpp>
+#include<string>
+#include<vector>
+
+// Sprite index meaning "no sprite", for StallInstance::sprite
+const GLuint NO_SPRITE = 0xFFFFFFFFu;
+// Number of sprite rectangles the stall shader can hold
+const GLuint MAX_ATLAS_SPRITES = 64;
+
+// Packs many small RGBA images into one texture with a skyline bottom-left packer,
+// so stalls and vehicles with different icons still share one texture and one draw
+class TextureAtlas
+{
+public:
+	// Reference ID of the atlas texture, 0 until Upload is called
+	GLuint ID;
+	// Size of the atlas in pixels
+	GLsizei Width, Height;
+	// Texture coordinates of each sprite: u0, v0, u1, v1
+	std::vector<glm::vec4> UVRects;
+	// Constructor that creates an empty atlas, padding pixels are left around every sprite
+	TextureAtlas(GLsizei width, GLsizei height, int padding = 1);
+
+	// Packs an RGBA image and returns its sprite index, or -1 if it does not fit
+	int Add(const unsigned char* rgba, int width, int height);
+	// Loads and packs image files tallest first, returns the sprite index of each file (-1 on failure)
+	std::vector<int> AddFiles(const std::vector<std::string>& paths);
+	// Creates the texture from the packed pixels
+	void Upload();
+	// Deletes the atlas texture
+	void Delete();
+
+private:
+	// Top edge of the packed area from x to x + width
+	struct SkylineNode
+	{
+		int x, y, width;
+	};
+	int padding;
+	std::vector<SkylineNode> skyline;
+	// CPU copy of the atlas, bottom row first like OpenGL
+	std::vector<unsigned char> pixels;
+
+	// Finds the lowest position for a width x height rectangle, returns the node it starts at or -1
+	int FindPosition(int width, int height, int& x, int& y) const;
+	// Raises the skyline over a placed rectangle
+	void Place(int node, int x, int y, int width, int height);
+};
+
+#endif
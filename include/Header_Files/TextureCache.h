@@ -0,0 +1,70 @@
+#ifndef TEXTURE_CACHE_CLASS_H
+#define TEXTURE_CACHE_CLASS_H
+
+#include<cstdint>
+#include<string>
+#include<string_view>
+#include<vector>
+#include"Header_Files/MappedFile.h"
+
+// One mip level of a cached image, rows bottom first and tightly packed
+struct CachedLevel
+{
+	int width, height;
+	const unsigned char* pixels;
+};
+
+// Decoded image found in the cache; the levels point into File until it is closed
+struct CachedImage
+{
+	MappedFile File;
+	int Channels;
+	std::vector<CachedLevel> Levels;
+};
+
+// On-disk cache of decoded images so warm start-ups skip PNG decoding entirely.
+// Each entry is one file named after a hash of the source path, modification time, size
+// and first and last 64 KiB of content, so a same-size rewrite within the resolution of
+// the modification time is not mistaken for the cached version. It holds the source
+// identity, a level table and the pixel data, aligned so the file can be memory-mapped
+// and its levels handed straight to glTexImage2D.
+class TextureCache
+{
+public:
+	// Directory the cache files are written to
+	std::string Directory;
+	// Constructor that uses directory for the cache, creating it if needed
+	TextureCache(const std::string& directory);
+
+	// Maps the cached copy of sourcePath if it exists and the source has not changed since
+	bool Find(const std::string& sourcePath, CachedImage& image) const;
+	// Maps the cached copy of a packed asset if it exists and its bytes have not changed since
+	bool Find(const std::string& name, std::string_view bytes, CachedImage& image) const;
+	// Stores decoded pixels (bottom row first), with a box-filtered mip chain if mipmaps is set
+	bool Store(const std::string& sourcePath, const unsigned char* pixels, int width, int height, int channels, bool mipmaps) const;
+	// Same as Store, for pixels decoded from the bytes of a packed asset
+	bool Store(const std::string& name, std::string_view bytes, const unsigned char* pixels, int width, int height, int channels, bool mipmaps) const;
+
+private:
+	// What a cache entry was made from: a file path or a marked pack name, and that source's identity
+	struct Version
+	{
+		std::string name;
+		int64_t modified;
+		uint64_t size;
+		uint64_t contentHash;
+	};
+
+	// Identifies the current version of a file on disk, returns false if it is missing
+	static bool FileVersion(const std::string& sourcePath, Version& version);
+	// Identifies the bytes of a packed asset; the name is marked so a loose file of the same path gets its own entry
+	static void PackedVersion(const std::string& name, std::string_view bytes, Version& version);
+	// Returns the cache file for a version of a source
+	std::string EntryPath(const Version& version) const;
+	// Maps the cache entry of a version if it exists and is intact
+	bool Find(const Version& version, CachedImage& image) const;
+	// Writes the cache entry of a version
+	bool Store(const Version& version, const unsigned char* pixels, int width, int height, int channels, bool mipmaps) const;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef TEXTURE_MANAGER_CLASS_H
+#define TEXTURE_MANAGER_CLASS_H
+
+#include<glad/glad.h>
+#include<deque>
+#include<mutex>
+#include<string>
+#include<vector>
+#include"Header_Files/ThreadPool.h"
+#include"Header_Files/TextureCache.h"
+
+// Index of a texture owned by a TextureManager
+typedef unsigned int TextureHandle;
+
+// Loads textures in the background: images are decoded with stb_image on the worker
+// threads of a ThreadPool, then streamed to the GPU through a pixel unpack buffer on
+// the GL thread, a few rows at a time so uploads stay within a per-frame budget.
+// Until a texture is ready its handle resolves to a placeholder texture. With a
+// TextureCache, images decoded once are mapped from the cache on later runs.
+class TextureManager
+{
+public:
+	// 2x2 checkerboard drawn in place of textures that are not ready yet
+	GLuint Placeholder;
+	// Milliseconds Update may spend uploading each frame
+	double UploadBudget;
+	// Constructor that creates the placeholder and the staging buffer, cache may be NULL
+	TextureManager(ThreadPool& pool, double uploadBudgetMs = 2.0, TextureCache* cache = NULL);
+
+	// Starts loading an image asset (see AssetVFS) and returns its handle immediately
+	TextureHandle Load(const std::string& path, GLint filter = GL_LINEAR, GLint wrap = GL_REPEAT);
+	// Loads every texture read from path again; each keeps showing its current image until
+	// the new one is uploaded, and keeps it if the new one fails. Returns false if none uses path
+	bool Reload(const std::string& path);
+	// Uploads decoded images within the budget, call once per frame on the GL thread
+	void Update();
+	// Blocks until every texture is decoded and uploaded
+	void Finish();
+	// Returns the texture ID for a handle, or Placeholder while it is still loading
+	GLuint GetID(TextureHandle handle) const;
+	// Returns true once the texture is uploaded
+	bool IsReady(TextureHandle handle) const;
+	// Returns true if the image could not be loaded
+	bool Failed(TextureHandle handle) const;
+	// Number of textures not uploaded yet
+	size_t Pending() const;
+	// Deletes every texture, the placeholder and the staging buffer
+	void Delete();
+
+private:
+	enum State
+	{
+		DECODING,
+		DECODED,
+		UPLOADING,
+		READY,
+		FAILED
+	};
+	struct Entry
+	{
+		std::string path;
+		GLint filter;
+		GLint wrap;
+		// Texture being uploaded, and the one handed out until that upload completes
+		GLuint id;
+		GLuint live;
+		State state;
+		// The file changed again while it was still loading
+		bool stale;
+		int width, height, channels;
+		// Level 0 pixels, either decoded or mapped from the cache
+		const unsigned char* pixels;
+		// Pixels owned by stb_image, freed once uploaded
+		unsigned char* decoded;
+		// Mapped cache entry with its mip levels, if the image came from the cache
+		CachedImage cached;
+		// Next row to upload
+		int uploadedRows;
+	};
+
+	ThreadPool& pool;
+	TextureCache* cache;
+	// Pixel unpack buffer the rows are staged in, orphaned before every chunk
+	GLuint stagingBuffer;
+	// Guards state and pixels written by the workers; deque keeps entries in place
+	mutable std::mutex mutex;
+	std::deque<Entry> entries;
+	// Handles whose upload has not finished, in load order
+	std::vector<TextureHandle> queue;
+
+	// Decodes one image on a worker thread
+	void Decode(TextureHandle handle);
+	// Uploads the next rows of a decoded image, returns true when it is complete
+	bool UploadRows(Entry& entry, int rows);
+	// Releases the decoded or mapped pixels of an entry
+	void ReleasePixels(Entry& entry);
+};
+
+#endif
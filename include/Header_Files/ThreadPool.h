@@ -0,0 +1,41 @@
+#ifndef THREAD_POOL_CLASS_H
+#define THREAD_POOL_CLASS_H
+
+#include<condition_variable>
+#include<deque>
+#include<functional>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+// Fixed set of worker threads running queued tasks in submission order
+class ThreadPool
+{
+public:
+	// Constructor that starts threadCount workers, 0 for one per hardware thread
+	ThreadPool(unsigned int threadCount = 0);
+
+	// Number of worker threads
+	unsigned int Size() const;
+	// Queues a task to run on one of the workers
+	void Enqueue(std::function<void()> task);
+	// Blocks until every queued task has finished
+	void Wait();
+	// Finishes the queued tasks and stops the workers
+	void Delete();
+
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()> > tasks;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+	// Tasks queued or running
+	size_t active;
+	bool stopping;
+
+	// Body of each worker thread
+	void WorkerLoop();
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef TILE_CACHE_CLASS_H
+#define TILE_CACHE_CLASS_H
+
+#include<glad/glad.h>
+#include<glm/glm.hpp>
+#include<cfloat>
+#include<cstdint>
+#include<functional>
+#include<unordered_map>
+#include<vector>
+#include"Header_Files/FBO.h"
+#include"Header_Files/RenderQueue.h"
+
+// Keeps the static layer of a layout rendered into fixed-size FBO tiles. Level 0 is
+// one tile over the whole layout and every level halves the tile size, the level in
+// view is the coarsest one with at least a tile pixel per screen pixel. Tiles are
+// only drawn again when they are missing or an edit invalidated them, so each frame
+// composites a few textured quads. The least recently shown tiles are reused first.
+class TileCache
+{
+public:
+	// Width and height of every tile in pixels
+	GLsizei TilePixels;
+	// Most tiles kept at once (no more than the constructor's maxTiles), each holds TilePixels * TilePixels * 4 bytes
+	size_t MaxTiles;
+	// Color the static layer is drawn over
+	glm::vec4 ClearColor;
+	// Tiles in view and tiles drawn by the last Update
+	size_t Visible, Rendered;
+	// Constructor that creates the composite quads, tiles are made on demand
+	TileCache(GLsizei tilePixels = 256, size_t maxTiles = 128);
+
+	// World rectangle (min x, min y, max x, max y) of the static layer, drops every tile
+	void SetBounds(const glm::vec4& bounds);
+	// Marks the tiles overlapping rect for redrawing, on the levels whose tiles are minSize to maxSize wide
+	void Invalidate(const glm::vec4& rect, float minSize = 0.0f, float maxSize = FLT_MAX);
+	// Marks every tile for redrawing
+	void InvalidateAll();
+	// Picks the level for pixelsPerUnit screen pixels per world unit and draws the missing and
+	// invalidated tiles overlapping visibleRect, calling drawTile(tile rect) with the tile's FBO bound
+	void Update(const glm::vec4& visibleRect, float pixelsPerUnit, const std::function<void(const glm::vec4&)>& drawTile);
+	// Records one textured quad per tile in view, program samples tex0 like default.frag
+	void Record(RenderQueue& queue, uint8_t layer, GLuint program);
+	// Deletes every tile and the composite quads
+	void Delete();
+
+private:
+	// Deepest level, its tiles are 2^-MAX_LEVEL of the layout
+	static constexpr int MAX_LEVEL = 20;
+	struct Tile
+	{
+		glm::vec4 rect;
+		// Index of the tile's FBO in targets
+		size_t target;
+		bool dirty;
+		// Update call the tile was last in view
+		unsigned long lastUsed;
+	};
+
+	glm::vec4 bounds;
+	std::vector<FBO> targets;
+	// FBOs in targets that no tile uses
+	std::vector<size_t> freeTargets;
+	// Tiles by level and position, see TileKey
+	std::unordered_map<uint64_t, Tile> tiles;
+	// Color textures of the tiles in view, in the order of their quads
+	std::vector<GLuint> visibleTextures;
+	std::vector<GLfloat> vertices;
+	unsigned long frame;
+	// Composite quads: 4 vertices (x, y, z, u, v) and 6 indices per tile in view
+	GLuint vao, vbo, ebo;
+	// Number of quads the composite buffers were made for
+	size_t quadCapacity;
+
+	// Packs a level and tile position into a map key
+	static uint64_t TileKey(int level, GLuint x, GLuint y);
+	// Returns a free FBO for a new tile, reusing the least recently shown one, or -1 if none can be had
+	long AcquireTarget();
+};
+
+#endif
@@ -14,6 +14,8 @@ public:
 
 	// Links a VBO to the VAO using a certain layout
 	void LinkVBO(VBO& VBO, GLuint layout);
+	// Links a VBO attribute to the VAO using a layout, component count, type, stride and offset
+	void LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset);
 	// Binds the VAO
 	void Bind();
 	// Unbinds the VAO
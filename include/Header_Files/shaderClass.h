@@ -7,6 +7,8 @@
 #include<sstream>
 #include<iostream>
 #include<cerrno>
+#include<unordered_map>
+#include"Header_Files/ShaderCache.h"
 
 std::string get_file_contents(const char* filename);
 
@@ -15,12 +17,28 @@ class Shader
 public:
 	// Reference ID of the Shader Program
 	GLuint ID;
-	// Constructor that build the Shader Program from 2 different shaders
-	Shader(const char* vertexFile, const char* fragmentFile);
+	// Constructor that build the Shader Program from 2 different shaders,
+	// loading the linked binary from cache instead when it holds one
+	Shader(const char* vertexFile, const char* fragmentFile, ShaderCache* cache = NULL);
+	// Constructor that takes ownership of an already linked Shader Program
+	Shader(GLuint program);
+
+	// Returns the cached location of an active uniform, -1 if the program has no such uniform
+	GLint GetUniformLocation(const std::string& name) const;
+	// Returns the cached index of an active uniform block, GL_INVALID_INDEX if there is none
+	GLuint GetUniformBlockIndex(const std::string& name) const;
 
 	// Activates the Shader Program
 	void Activate();
 	// Deletes the Shader Program
 	void Delete();
+
+private:
+	// Active uniform locations and uniform block indices, filled in once after linking
+	std::unordered_map<std::string, GLint> uniformLocations;
+	std::unordered_map<std::string, GLuint> uniformBlockIndices;
+
+	// Reflects all active uniforms and uniform blocks and binds the shared blocks
+	void Reflect();
 };
 #endif
\ No newline at end of file
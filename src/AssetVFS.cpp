@@ -0,0 +1,316 @@
+#include"Header_Files/AssetVFS.h"
+#include<sys/stat.h>
+#include<algorithm>
+#include<cstdint>
+#include<cstdio>
+#include<cstring>
+#include<fstream>
+#include<iostream>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+// Identifies pack files and their layout version
+static const char PACK_MAGIC[8] = { 'P', 'A', 'L', 'P', 'A', 'K', 0, 1 };
+// Every file's data starts on this boundary
+static const uint64_t PACK_ALIGNMENT = 16;
+
+// Fixed-size start of a pack: magic, entry count, then the table of contents
+struct PackHeader
+{
+	char magic[8];
+	uint32_t count;
+	uint32_t reserved;
+};
+
+// Table of contents entry, followed by nameLength bytes of name
+struct PackEntry
+{
+	uint64_t offset;
+	uint64_t size;
+	uint32_t nameLength;
+	uint32_t reserved;
+};
+
+// Rounds value up to the next multiple of PACK_ALIGNMENT
+static uint64_t align_up(uint64_t value)
+{
+	return (value + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+}
+
+// Gets the directory where the executable is located
+static std::string get_executable_dir()
+{
+#ifdef _WIN32
+	char path[MAX_PATH];
+	if (GetModuleFileNameA(NULL, path, MAX_PATH) != 0)
+	{
+		std::string exePath(path);
+		size_t lastSlash = exePath.find_last_of("\\/");
+		if (lastSlash != std::string::npos)
+		{
+			return exePath.substr(0, lastSlash + 1);
+		}
+	}
+	return "";
+#else
+	// For non-Windows, return empty (use relative paths)
+	return "";
+#endif
+}
+
+// Returns true if path names a directory
+static bool is_directory(const std::string& path)
+{
+	struct stat info;
+	return stat(path.c_str(), &info) == 0 && (info.st_mode & S_IFMT) == S_IFDIR;
+}
+
+// Adds every file below the directory at path to names, as name followed by the path below it
+static void list_files(const std::string& path, const std::string& name, std::vector<std::string>& names)
+{
+#ifdef _WIN32
+	WIN32_FIND_DATAA entry;
+	HANDLE find = FindFirstFileA((path + "\\*").c_str(), &entry);
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+	do
+	{
+		std::string child = entry.cFileName;
+		if (child == "." || child == "..")
+			continue;
+		if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			list_files(path + "/" + child, name + "/" + child, names);
+		else
+			names.push_back(name + "/" + child);
+	} while (FindNextFileA(find, &entry));
+	FindClose(find);
+#else
+	DIR* directory = opendir(path.c_str());
+	if (directory == NULL)
+		return;
+	while (dirent* entry = readdir(directory))
+	{
+		std::string child = entry->d_name;
+		if (child == "." || child == "..")
+			continue;
+		struct stat info;
+		if (stat((path + "/" + child).c_str(), &info) != 0)
+			continue;
+		if ((info.st_mode & S_IFMT) == S_IFDIR)
+			list_files(path + "/" + child, name + "/" + child, names);
+		else if ((info.st_mode & S_IFMT) == S_IFREG)
+			names.push_back(name + "/" + child);
+	}
+	closedir(directory);
+#endif
+}
+
+// Constructor that resolves the root by looking for Resource_Files near the working directory and the executable
+AssetVFS::AssetVFS()
+{
+	std::string exeDir = get_executable_dir();
+	std::string roots[] = {
+		"",
+		"../",
+		"../../",
+		exeDir,
+		exeDir + "../",
+	};
+	const int numRoots = sizeof(roots) / sizeof(roots[0]);
+
+	Root = "";
+	for (int i = 0; i < numRoots; i++)
+	{
+		if (is_directory(roots[i] + "Resource_Files"))
+		{
+			Root = roots[i];
+			break;
+		}
+	}
+}
+
+// Returns the instance every loader reads through
+AssetVFS& AssetVFS::Default()
+{
+	static AssetVFS instance;
+	return instance;
+}
+
+// Maps a pack file, its entries take precedence over loose files; returns false if it cannot be read
+bool AssetVFS::Mount(const std::string& packPath)
+{
+	MappedFile pack;
+	if (!pack.Open(packPath))
+		return false;
+
+	const PackHeader* header = (const PackHeader*)pack.Data;
+	if (pack.Size < sizeof(PackHeader) || memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0)
+	{
+		std::cerr << "ERROR: Not an asset pack: " << packPath << std::endl;
+		pack.Close();
+		return false;
+	}
+
+	// Validate the whole table before adding anything, a truncated pack is rejected outright
+	std::vector<std::pair<std::string, std::string_view> > found;
+	size_t position = sizeof(PackHeader);
+	for (uint32_t i = 0; i < header->count; i++)
+	{
+		PackEntry entry;
+		if (position + sizeof(PackEntry) > pack.Size)
+			break;
+		memcpy(&entry, pack.Data + position, sizeof(entry));
+		position += sizeof(PackEntry);
+		if (position + entry.nameLength > pack.Size || entry.offset > pack.Size || entry.size > pack.Size - entry.offset)
+			break;
+		std::string name((const char*)pack.Data + position, entry.nameLength);
+		position += entry.nameLength;
+		found.push_back(std::make_pair(name, std::string_view((const char*)pack.Data + entry.offset, (size_t)entry.size)));
+	}
+	if (found.size() != header->count)
+	{
+		std::cerr << "ERROR: Asset pack is truncated: " << packPath << std::endl;
+		pack.Close();
+		return false;
+	}
+
+	for (size_t i = 0; i < found.size(); i++)
+		entries[found[i].first] = found[i].second;
+	packs.push_back(pack);
+	return true;
+}
+
+// Returns a view of a packed asset, false if no mounted pack holds it
+bool AssetVFS::Find(const std::string& name, std::string_view& data) const
+{
+	std::unordered_map<std::string, std::string_view>::const_iterator it = entries.find(name);
+	if (it == entries.end())
+		return false;
+	data = it->second;
+	return true;
+}
+
+// Copies an asset from the pack or from disk into contents, returns false if it does not exist
+bool AssetVFS::Read(const std::string& name, std::string& contents) const
+{
+	std::string_view packed;
+	if (Find(name, packed))
+	{
+		contents.assign(packed.data(), packed.size());
+		return true;
+	}
+
+	// Opening at the end gives the size without a separate seek
+	std::ifstream in(Resolve(name).c_str(), std::ios::binary | std::ios::ate);
+	if (!in)
+		return false;
+	contents.resize((size_t)in.tellg());
+	in.seekg(0, std::ios::beg);
+	return (bool)in.read(&contents[0], contents.size());
+}
+
+// Returns the path on disk of an asset
+std::string AssetVFS::Resolve(const std::string& name) const
+{
+	// Absolute paths are used as they are
+	if (!name.empty() && (name[0] == '/' || name[0] == '\\' || (name.size() > 1 && name[1] == ':')))
+		return name;
+	return Root + name;
+}
+
+// Lists every file below an asset directory, as asset names
+std::vector<std::string> AssetVFS::List(const std::string& directory) const
+{
+	// Walked with the platform's directory calls, std::filesystem needs -lstdc++fs on older MinGW
+	std::vector<std::string> names;
+	std::string name = directory;
+	while (!name.empty() && (name.back() == '/' || name.back() == '\\'))
+		name.pop_back();
+	list_files(Resolve(name), name, names);
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+// Writes the given assets into a pack file, returns false if any cannot be read or written
+bool AssetVFS::WritePack(const std::string& packPath, const std::vector<std::string>& names) const
+{
+	std::vector<std::string> contents(names.size());
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		if (!Read(names[i], contents[i]))
+		{
+			std::cerr << "ERROR: Failed to read asset: " << names[i] << std::endl;
+			return false;
+		}
+	}
+
+	// Lay the data out after the table of contents
+	PackHeader header;
+	memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+	header.count = (uint32_t)names.size();
+	header.reserved = 0;
+	uint64_t offset = sizeof(PackHeader);
+	for (size_t i = 0; i < names.size(); i++)
+		offset += sizeof(PackEntry) + names[i].size();
+	std::vector<PackEntry> table(names.size());
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		offset = align_up(offset);
+		table[i].offset = offset;
+		table[i].size = contents[i].size();
+		table[i].nameLength = (uint32_t)names[i].size();
+		table[i].reserved = 0;
+		offset += contents[i].size();
+	}
+
+	// Write to a temporary name first so a crash never leaves a truncated pack behind
+	std::string temporary = packPath + ".tmp";
+	{
+		std::ofstream out(temporary.c_str(), std::ios::binary);
+		if (!out)
+		{
+			std::cerr << "ERROR: Failed to create asset pack: " << packPath << std::endl;
+			return false;
+		}
+		out.write((const char*)&header, sizeof(header));
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			out.write((const char*)&table[i], sizeof(PackEntry));
+			out.write(names[i].data(), names[i].size());
+		}
+		static const char zeros[PACK_ALIGNMENT] = { 0 };
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			uint64_t position = (uint64_t)out.tellp();
+			out.write(zeros, (std::streamsize)(table[i].offset - position));
+			out.write(contents[i].data(), contents[i].size());
+		}
+		if (!out)
+		{
+			std::cerr << "ERROR: Failed to write asset pack: " << packPath << std::endl;
+			out.close();
+			remove(temporary.c_str());
+			return false;
+		}
+	}
+	remove(packPath.c_str());
+	if (rename(temporary.c_str(), packPath.c_str()) != 0)
+	{
+		std::cerr << "ERROR: Failed to replace asset pack: " << packPath << std::endl;
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+// Unmaps every pack
+void AssetVFS::Delete()
+{
+	entries.clear();
+	for (size_t i = 0; i < packs.size(); i++)
+		packs[i].Close();
+	packs.clear();
+}
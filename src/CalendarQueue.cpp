@@ -0,0 +1,216 @@
+#include"Header_Files/CalendarQueue.h"
+#include<cmath>
+
+// Index that ends a list of nodes
+static const uint32_t NONE = 0xFFFFFFFFu;
+// Fewest buckets kept, and most events sampled to estimate the width
+static const size_t MIN_BUCKETS = 2;
+static const int WIDTH_SAMPLES = 25;
+
+// Constructor that starts empty with a few buckets of the given width
+CalendarQueue::CalendarQueue(double width)
+{
+	Width = width;
+	freeList = NONE;
+	count = 0;
+	current = 0;
+	currentDay = 0;
+	resizing = false;
+	buckets.assign(MIN_BUCKETS, NONE);
+	growAt = 2 * MIN_BUCKETS;
+	shrinkAt = 0;
+}
+
+// Grows the pool and buckets to hold events pending at once without allocating
+void CalendarQueue::Reserve(size_t events)
+{
+	pool.reserve(events);
+	// Resizing never asks for more than twice as many buckets as events
+	buckets.reserve(2 * events + MIN_BUCKETS);
+}
+
+// Adds an event
+void CalendarQueue::Push(double time, uint32_t kind, uint32_t subject)
+{
+	uint32_t node = freeList;
+	if (node != NONE)
+		freeList = pool[node].next;
+	else
+	{
+		node = (uint32_t)pool.size();
+		pool.push_back(Node());
+	}
+	pool[node].event.time = time;
+	pool[node].event.kind = kind;
+	pool[node].event.subject = subject;
+	// An empty queue starts looking on the new event's day, and an event before that day moves the search back
+	if (count == 0 || (uint64_t)(time / Width) < currentDay)
+		SeekTo(time);
+	Insert(node);
+	count++;
+	if (count > growAt && !resizing)
+		Resize(2 * buckets.size());
+}
+
+// Removes the earliest event into event, returns false if the queue is empty
+bool CalendarQueue::Pop(SimEvent& event)
+{
+	if (count == 0)
+		return false;
+	uint32_t node = RemoveFirst();
+	event = pool[node].event;
+	pool[node].next = freeList;
+	freeList = node;
+	if (count < shrinkAt && !resizing)
+		Resize(buckets.size() / 2);
+	return true;
+}
+
+// Returns the time of the earliest event without removing it, the queue must not be empty
+double CalendarQueue::PeekTime()
+{
+	return pool[FindFirst()].event.time;
+}
+
+// Number of events pending
+size_t CalendarQueue::Size() const
+{
+	return count;
+}
+
+// Removes every event, keeping the pool
+void CalendarQueue::Clear()
+{
+	freeList = NONE;
+	for (size_t i = pool.size(); i-- > 0;)
+	{
+		pool[i].next = freeList;
+		freeList = (uint32_t)i;
+	}
+	buckets.assign(buckets.size(), NONE);
+	count = 0;
+}
+
+// Links a node into its bucket after any events with the same time
+void CalendarQueue::Insert(uint32_t node)
+{
+	double time = pool[node].event.time;
+	uint32_t* link = &buckets[(uint64_t)(time / Width) % buckets.size()];
+	while (*link != NONE && pool[*link].event.time <= time)
+		link = &pool[*link].next;
+	pool[node].next = *link;
+	*link = node;
+}
+
+// Moves current to the bucket and day of time
+void CalendarQueue::SeekTo(double time)
+{
+	currentDay = (uint64_t)(time / Width);
+	current = currentDay % buckets.size();
+}
+
+// Moves current to the bucket holding the earliest node and returns it, count must not be 0
+uint32_t CalendarQueue::FindFirst()
+{
+	// Walk one year of days; the earliest event is the first found on its own day
+	for (size_t n = 0; n < buckets.size(); n++)
+	{
+		uint32_t head = buckets[current];
+		if (head != NONE && (uint64_t)(pool[head].event.time / Width) <= currentDay)
+			return head;
+		current = current + 1 == buckets.size() ? 0 : current + 1;
+		currentDay++;
+	}
+
+	// Nothing within a year: jump straight to the earliest head
+	uint32_t first = NONE;
+	for (size_t b = 0; b < buckets.size(); b++)
+	{
+		uint32_t head = buckets[b];
+		if (head != NONE && (first == NONE || pool[head].event.time < pool[first].event.time))
+			first = head;
+	}
+	SeekTo(pool[first].event.time);
+	return first;
+}
+
+// Unlinks the earliest node, count must not be 0
+uint32_t CalendarQueue::RemoveFirst()
+{
+	uint32_t node = FindFirst();
+	buckets[current] = pool[node].next;
+	count--;
+	return node;
+}
+
+// Changes the bucket count, re-estimating the width from the events at the front
+void CalendarQueue::Resize(size_t bucketCount)
+{
+	if (bucketCount < MIN_BUCKETS)
+		bucketCount = MIN_BUCKETS;
+	resizing = true;
+
+	// The average gap between the first events, ignoring outliers, sets the width (Brown's estimate)
+	uint32_t samples[WIDTH_SAMPLES];
+	int sampled = 0;
+	while (sampled < WIDTH_SAMPLES && count > 0)
+		samples[sampled++] = RemoveFirst();
+	if (sampled > 1)
+	{
+		double span = pool[samples[sampled - 1]].event.time - pool[samples[0]].event.time;
+		double average = span / (sampled - 1);
+		double sum = 0.0;
+		int gaps = 0;
+		for (int i = 1; i < sampled; i++)
+		{
+			double gap = pool[samples[i]].event.time - pool[samples[i - 1]].event.time;
+			if (gap <= 2.0 * average)
+			{
+				sum += gap;
+				gaps++;
+			}
+		}
+		if (gaps > 0 && sum > 0.0)
+			Width = 3.0 * sum / gaps;
+	}
+
+	// Relink every node: the old buckets into one chain, then into the new buckets
+	uint32_t chain = NONE;
+	for (size_t b = 0; b < buckets.size(); b++)
+	{
+		uint32_t node = buckets[b];
+		while (node != NONE)
+		{
+			uint32_t next = pool[node].next;
+			pool[node].next = chain;
+			chain = node;
+			node = next;
+		}
+	}
+	buckets.assign(bucketCount, NONE);
+	// Sampled events go back first: they are the earliest, and come before later ones with equal times
+	for (int i = 0; i < sampled; i++)
+		Insert(samples[i]);
+	// The chain is reversed; re-reversing it keeps equal times in their pushed order
+	uint32_t ordered = NONE;
+	while (chain != NONE)
+	{
+		uint32_t next = pool[chain].next;
+		pool[chain].next = ordered;
+		ordered = chain;
+		chain = next;
+	}
+	while (ordered != NONE)
+	{
+		uint32_t next = pool[ordered].next;
+		Insert(ordered);
+		ordered = next;
+	}
+	count += sampled;
+
+	growAt = 2 * bucketCount;
+	shrinkAt = bucketCount > MIN_BUCKETS ? bucketCount / 2 - 2 : 0;
+	if (sampled > 0)
+		SeekTo(pool[samples[0]].event.time);
+	resizing = false;
+}
@@ -0,0 +1,80 @@
+#include"Header_Files/Camera2D.h"
+#include<glm/gtc/matrix_transform.hpp>
+#include<algorithm>
+#include<cmath>
+
+// Smallest and largest zoom the keys can reach
+static const float MIN_ZOOM = 0.25f;
+static const float MAX_ZOOM = 256.0f;
+
+// Returns the world rectangle that a view-projection matrix maps onto the screen
+static glm::vec4 unproject_screen(const glm::mat4& viewProjection)
+{
+	glm::mat4 inverse = glm::inverse(viewProjection);
+	glm::vec4 rect(1e30f, 1e30f, -1e30f, -1e30f);
+	for (int i = 0; i < 4; i++)
+	{
+		glm::vec4 corner = inverse * glm::vec4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, 0.0f, 1.0f);
+		glm::vec2 point = glm::vec2(corner) / corner.w;
+		rect = glm::vec4(glm::min(glm::vec2(rect), point), glm::max(glm::vec2(rect.z, rect.w), point));
+	}
+	return rect;
+}
+
+// Constructor that shows everything the projection shows
+Camera2D::Camera2D(const glm::mat4& projection)
+{
+	Reset(projection);
+}
+
+// Projection the view is relative to, resets the camera
+void Camera2D::Reset(const glm::mat4& projection)
+{
+	this->projection = projection;
+	glm::vec4 rect = unproject_screen(projection);
+	home = glm::vec2(0.5f * (rect.x + rect.z), 0.5f * (rect.y + rect.w));
+	homeSize = glm::vec2(rect.z - rect.x, rect.w - rect.y);
+	Center = home;
+	Zoom = 1.0f;
+}
+
+// Moves the camera for the keys held down over seconds, returns true while any of them is held
+bool Camera2D::Update(GLFWwindow* window, float seconds)
+{
+	glm::vec2 pan(0.0f);
+	float zoom = 0.0f;
+	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+		pan.x -= 1.0f;
+	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+		pan.x += 1.0f;
+	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+		pan.y -= 1.0f;
+	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+		pan.y += 1.0f;
+	if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS)
+		zoom -= 1.0f;
+	if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS)
+		zoom += 1.0f;
+	if (pan == glm::vec2(0.0f) && zoom == 0.0f)
+		return false;
+
+	// Pan by most of a screen per second whatever the zoom, and double the zoom every second
+	Center += pan * homeSize * (0.75f * seconds / Zoom);
+	Zoom = std::min(std::max(Zoom * powf(2.0f, zoom * seconds), MIN_ZOOM), MAX_ZOOM);
+	return true;
+}
+
+// Returns the view matrix
+glm::mat4 Camera2D::View() const
+{
+	// Scale around the home point, after bringing Center there
+	glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(home, 0.0f));
+	view = glm::scale(view, glm::vec3(Zoom, Zoom, 1.0f));
+	return glm::translate(view, glm::vec3(-Center, 0.0f));
+}
+
+// Returns the world rectangle (min x, min y, max x, max y) visible through the projection and view
+glm::vec4 Camera2D::VisibleRect() const
+{
+	return unproject_screen(projection * View());
+}
@@ -0,0 +1,198 @@
+#include"Header_Files/DynamicAttributeBuffer.h"
+#include"Header_Files/GLStateCache.h"
+#include<algorithm>
+#include<cstring>
+
+// Dirty ranges closer than this are sent in one call, re-sending the clean bytes between them
+static const GLsizeiptr MERGE_GAP = 256;
+
+// Constructor that generates a Buffer Object for target holding size bytes of data (may be NULL)
+DynamicAttributeBuffer::DynamicAttributeBuffer(GLenum target, const void* data, GLsizeiptr size)
+{
+	this->target = target;
+	Size = size;
+	Capacity = size;
+	FullUploadRatio = 0.5f;
+	Uploaded = 0;
+	Uploads = 0;
+	dirtyBytes = 0;
+	reallocate = false;
+	shadow.resize(size);
+	if (data != NULL && size > 0)
+		memcpy(shadow.data(), data, size);
+
+	glGenBuffers(1, &ID);
+	GLStateCache::Current().BindBuffer(target, ID);
+	glBufferData(target, size, data, GL_DYNAMIC_DRAW);
+	GLStateCache::Current().BindBuffer(target, 0);
+}
+
+// Adds [begin, end) to the dirty ranges, merging it with those it overlaps or touches
+void DynamicAttributeBuffer::MarkDirty(GLintptr begin, GLintptr end)
+{
+	if (begin >= end)
+		return;
+	// Start from the last range beginning at or before begin, it may reach into the new one
+	std::map<GLintptr, GLintptr>::iterator it = dirty.upper_bound(begin);
+	if (it != dirty.begin())
+	{
+		std::map<GLintptr, GLintptr>::iterator previous = it;
+		--previous;
+		if (previous->second >= begin)
+			it = previous;
+	}
+	while (it != dirty.end() && it->first <= end)
+	{
+		begin = std::min(begin, it->first);
+		end = std::max(end, it->second);
+		dirtyBytes -= it->second - it->first;
+		it = dirty.erase(it);
+	}
+	dirty[begin] = end;
+	dirtyBytes += end - begin;
+}
+
+// Copies size bytes to offset and marks them dirty, growing the buffer if they end past Size
+void DynamicAttributeBuffer::Write(GLintptr offset, const void* data, GLsizeiptr size)
+{
+	if (size <= 0)
+		return;
+	if (offset + size > Size)
+		Resize(offset + size);
+	memcpy(shadow.data() + offset, data, size);
+	MarkDirty(offset, offset + size);
+}
+
+// Like Write, but only marks the stride-sized records that differ from what is stored
+void DynamicAttributeBuffer::WriteChanged(GLintptr offset, const void* data, GLsizeiptr size, GLsizeiptr stride)
+{
+	if (size <= 0)
+		return;
+	// Without a record size there is nothing to compare, so everything is written
+	if (stride <= 0)
+	{
+		Write(offset, data, size);
+		return;
+	}
+	// Bytes past the old end have nothing to compare against and are dirty anyway
+	GLsizeiptr oldSize = Size;
+	if (offset + size > Size)
+		Resize(offset + size);
+	const unsigned char* source = (const unsigned char*)data;
+	GLintptr runStart = -1;
+	for (GLsizeiptr done = 0; done < size; done += stride)
+	{
+		GLintptr at = offset + done;
+		GLsizeiptr bytes = std::min(stride, size - done);
+		bool changed = at + bytes > oldSize || memcmp(shadow.data() + at, source + done, bytes) != 0;
+		if (changed)
+		{
+			memcpy(shadow.data() + at, source + done, bytes);
+			if (runStart < 0)
+				runStart = at;
+		}
+		else if (runStart >= 0)
+		{
+			MarkDirty(runStart, at);
+			runStart = -1;
+		}
+	}
+	if (runStart >= 0)
+		MarkDirty(runStart, offset + size);
+}
+
+// Sets the bytes in use, kept bytes stay as they are
+void DynamicAttributeBuffer::Resize(GLsizeiptr size)
+{
+	shadow.resize(size);
+	if (size > Capacity)
+	{
+		// Storage is reallocated with room to grow, and everything is uploaded with it
+		Capacity = std::max(size, Capacity + Capacity / 2);
+		reallocate = true;
+	}
+	GLsizeiptr oldSize = Size;
+	Size = size;
+	// Grown bytes are zero here but whatever was left on the GPU
+	if (size > oldSize)
+		MarkDirty(oldSize, size);
+	// Ranges past the new end have nothing left to upload
+	while (!dirty.empty() && dirty.rbegin()->second > size)
+	{
+		std::map<GLintptr, GLintptr>::iterator last = --dirty.end();
+		GLintptr begin = last->first;
+		dirtyBytes -= last->second - begin;
+		dirty.erase(last);
+		if (begin < size)
+			MarkDirty(begin, size);
+	}
+}
+
+// Returns the shadow copy
+const unsigned char* DynamicAttributeBuffer::Data() const
+{
+	return shadow.data();
+}
+
+// Returns the number of bytes waiting for Flush
+GLsizeiptr DynamicAttributeBuffer::DirtyBytes() const
+{
+	return dirtyBytes;
+}
+
+// Uploads the dirty ranges, call on the GL thread before drawing
+void DynamicAttributeBuffer::Flush()
+{
+	Uploaded = 0;
+	Uploads = 0;
+	if (!reallocate && dirty.empty())
+		return;
+
+	GLStateCache::Current().BindBuffer(target, ID);
+	if (reallocate || (float)dirtyBytes >= FullUploadRatio * (float)Size)
+	{
+		// Orphan the old storage so the upload does not wait for draws still reading it
+		glBufferData(target, Capacity, NULL, GL_DYNAMIC_DRAW);
+		if (Size > 0)
+			glBufferSubData(target, 0, Size, shadow.data());
+		Uploaded = Size;
+		Uploads = 1;
+	}
+	else
+	{
+		std::map<GLintptr, GLintptr>::iterator it = dirty.begin();
+		while (it != dirty.end())
+		{
+			GLintptr begin = it->first;
+			GLintptr end = it->second;
+			for (++it; it != dirty.end() && it->first - end < MERGE_GAP; ++it)
+				end = it->second;
+			glBufferSubData(target, begin, end - begin, shadow.data() + begin);
+			Uploaded += end - begin;
+			Uploads++;
+		}
+	}
+	GLStateCache::Current().BindBuffer(target, 0);
+	dirty.clear();
+	dirtyBytes = 0;
+	reallocate = false;
+}
+
+// Binds the Buffer Object
+void DynamicAttributeBuffer::Bind()
+{
+	GLStateCache::Current().BindBuffer(target, ID);
+}
+
+// Unbinds the Buffer Object
+void DynamicAttributeBuffer::Unbind()
+{
+	GLStateCache::Current().BindBuffer(target, 0);
+}
+
+// Deletes the Buffer Object
+void DynamicAttributeBuffer::Delete()
+{
+	GLStateCache::Current().ForgetBuffer(ID);
+	glDeleteBuffers(1, &ID);
+}
@@ -0,0 +1,62 @@
+#include"Header_Files/FBO.h"
+#include"Header_Files/GLStateCache.h"
+
+// Constructor that generates a Framebuffer Object with an RGBA color texture
+FBO::FBO(GLsizei width, GLsizei height)
+{
+	Width = width;
+	Height = height;
+
+	glGenTextures(1, &ColorTexture);
+	GLStateCache::Current().BindTexture(GL_TEXTURE_2D, ColorTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	GLStateCache::Current().BindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &ID);
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, ColorTexture, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Returns true if the driver accepted the attachments
+bool FBO::IsComplete()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	return status == GL_FRAMEBUFFER_COMPLETE;
+}
+
+// Binds the FBO and sets the viewport to cover it
+void FBO::Bind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	glViewport(0, 0, Width, Height);
+}
+
+// Binds the default framebuffer again
+void FBO::Unbind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Copies the color attachment into rgba (Width * Height * 4 bytes, bottom row first)
+void FBO::ReadPixels(unsigned char* rgba)
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+// Deletes the FBO and its color texture
+void FBO::Delete()
+{
+	glDeleteFramebuffers(1, &ID);
+	GLStateCache::Current().ForgetTexture(ColorTexture);
+	glDeleteTextures(1, &ColorTexture);
+}
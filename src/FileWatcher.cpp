@@ -0,0 +1,128 @@
+#include"Header_Files/FileWatcher.h"
+#include<algorithm>
+#include<iostream>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Constructor that starts the watcher thread, notify is called on that thread after every change
+FileWatcher::FileWatcher(std::function<void()> notify)
+{
+	this->notify = notify;
+	Supported = false;
+#ifdef __linux__
+	wakeFds[0] = wakeFds[1] = -1;
+	inotifyFd = inotify_init1(IN_CLOEXEC);
+	if (inotifyFd < 0)
+	{
+		std::cerr << "ERROR: File notifications are unavailable, hot reload is off" << std::endl;
+		return;
+	}
+	if (pipe(wakeFds) != 0)
+	{
+		close(inotifyFd);
+		inotifyFd = -1;
+		return;
+	}
+	Supported = true;
+	thread = std::thread(&FileWatcher::WatchLoop, this);
+#endif
+}
+
+// Watches the directory at path, changes are reported as name + "/" + file name
+bool FileWatcher::Watch(const std::string& path, const std::string& name)
+{
+#ifdef __linux__
+	if (!Supported)
+		return false;
+	// Editors either rewrite a file in place or write a copy and rename it over the original
+	int descriptor = inotify_add_watch(inotifyFd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (descriptor < 0)
+	{
+		std::cerr << "ERROR: Failed to watch directory: " << path << std::endl;
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	directories[descriptor] = name;
+	return true;
+#else
+	(void)path;
+	(void)name;
+	return false;
+#endif
+}
+
+// Returns every changed file since the last call, each once, in the order they changed
+std::vector<std::string> FileWatcher::Poll()
+{
+	std::vector<std::string> files;
+	std::lock_guard<std::mutex> lock(mutex);
+	files.swap(changed);
+	return files;
+}
+
+#ifdef __linux__
+// Body of the watcher thread
+void FileWatcher::WatchLoop()
+{
+	alignas(struct inotify_event) char buffer[4096];
+	for (;;)
+	{
+		struct pollfd fds[2];
+		fds[0].fd = inotifyFd;
+		fds[0].events = POLLIN;
+		fds[1].fd = wakeFds[0];
+		fds[1].events = POLLIN;
+		if (poll(fds, 2, -1) < 0)
+			continue;
+		if (fds[1].revents != 0)
+			return;
+
+		ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+		if (length <= 0)
+			continue;
+		std::unique_lock<std::mutex> lock(mutex);
+		size_t reported = changed.size();
+		for (ssize_t offset = 0; offset < length; )
+		{
+			const struct inotify_event* event = (const struct inotify_event*)(buffer + offset);
+			offset += sizeof(struct inotify_event) + event->len;
+			std::unordered_map<int, std::string>::iterator directory = directories.find(event->wd);
+			if (event->len == 0 || directory == directories.end())
+				continue;
+			// Saving often fires several events for one file, report it once
+			std::string file = directory->second + "/" + event->name;
+			if (std::find(changed.begin(), changed.end(), file) == changed.end())
+				changed.push_back(file);
+		}
+		bool added = changed.size() != reported;
+		lock.unlock();
+		if (added && notify)
+			notify();
+	}
+}
+#endif
+
+// Stops the watcher thread
+void FileWatcher::Delete()
+{
+#ifdef __linux__
+	if (!Supported)
+		return;
+	char wake = 0;
+	if (write(wakeFds[1], &wake, 1) != 1)
+	{
+		// The thread cannot be woken, leave it blocked rather than hang here
+		thread.detach();
+		Supported = false;
+		return;
+	}
+	thread.join();
+	close(wakeFds[0]);
+	close(wakeFds[1]);
+	close(inotifyFd);
+	Supported = false;
+#endif
+}
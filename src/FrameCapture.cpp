@@ -0,0 +1,320 @@
+#include"Header_Files/FrameCapture.h"
+#include"Header_Files/GLStateCache.h"
+#include"Header_Files/ImageWriter.h"
+#include<cstdio>
+#include<cstring>
+#include<iostream>
+
+// Constructor that generates ringSize pixel pack buffers of width * height RGBA pixels
+FrameCapture::FrameCapture(GLsizei width, GLsizei height, GLuint ringSize)
+{
+	Width = width;
+	Height = height;
+	Recording = false;
+	Dropped = 0;
+	nextSlot = 0;
+	format = PNG_SEQUENCE;
+	framesPerSecond = 60;
+	frameNumber = 0;
+
+	slots.resize(ringSize < 2 ? 2 : ringSize);
+	for (size_t i = 0; i < slots.size(); i++)
+	{
+		glGenBuffers(1, &slots[i].buffer);
+		GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, slots[i].buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, NULL, GL_STREAM_READ);
+		slots[i].fence = 0;
+		slots[i].job.kind = NO_JOB;
+		slots[i].job.screenshot = false;
+	}
+	GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	encoder = std::thread(&FrameCapture::EncodeLoop, this);
+}
+
+// Starts recording into a directory of numbered PNGs or a single .y4m file
+bool FrameCapture::StartRecording(const std::string& path, Format format, int framesPerSecond)
+{
+	if (Recording)
+		StopRecording();
+	this->format = format;
+	recordPath = path;
+	this->framesPerSecond = framesPerSecond > 0 ? framesPerSecond : 60;
+	frameNumber = 0;
+	Recording = true;
+	return true;
+}
+
+// Stops recording once the frames already read back are written
+void FrameCapture::StopRecording()
+{
+	if (!Recording)
+		return;
+	Recording = false;
+	// Frames still in flight belong to this recording, so collect them before closing
+	for (size_t i = 0; i < slots.size(); i++)
+		Collect(slots[(nextSlot + i) % slots.size()], true);
+	if (format == Y4M)
+	{
+		Job job;
+		job.kind = CLOSE_VIDEO;
+		job.path = recordPath;
+		job.screenshot = false;
+		job.framesPerSecond = framesPerSecond;
+		Enqueue(job);
+	}
+}
+
+// Saves the next captured frame as a PNG file
+void FrameCapture::Screenshot(const std::string& path)
+{
+	pendingScreenshot = path;
+}
+
+// Queues a readback of framebuffer (0 for the back buffer), call after drawing and before swapping
+void FrameCapture::Capture(GLuint framebuffer)
+{
+	// Hand over every readback that has already finished without waiting for the rest
+	for (size_t i = 0; i < slots.size(); i++)
+		Collect(slots[(nextSlot + i) % slots.size()], false);
+
+	if (!Recording && pendingScreenshot.empty())
+		return;
+
+	// The oldest slot is reused; it was queued ringSize frames ago so this rarely blocks
+	Slot& slot = slots[nextSlot];
+	Collect(slot, true);
+	// A readback still unfinished after a second keeps its slot, this frame is skipped instead
+	if (slot.fence != 0)
+	{
+		Dropped++;
+		return;
+	}
+	nextSlot = (nextSlot + 1) % slots.size();
+
+	if (!pendingScreenshot.empty())
+	{
+		slot.job.kind = WRITE_PNG;
+		slot.job.path = pendingScreenshot;
+		slot.job.screenshot = true;
+		pendingScreenshot.clear();
+	}
+	else if (format == PNG_SEQUENCE)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "/frame_%06lu.png", frameNumber++);
+		slot.job.kind = WRITE_PNG;
+		slot.job.path = recordPath + name;
+		slot.job.screenshot = false;
+	}
+	else
+	{
+		slot.job.kind = WRITE_Y4M_FRAME;
+		slot.job.path = recordPath;
+		slot.job.screenshot = false;
+		frameNumber++;
+	}
+	slot.job.framesPerSecond = framesPerSecond;
+
+	// With a pack buffer bound glReadPixels only queues the copy and returns at once
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	if (framebuffer == 0)
+		glReadBuffer(GL_BACK);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	glReadPixels(0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+	GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+// Maps a finished slot, copies its pixels and queues them for the encoder
+void FrameCapture::Collect(Slot& slot, bool wait)
+{
+	if (slot.fence == 0)
+		return;
+	GLenum result = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000ull : 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+		return;
+	glDeleteSync(slot.fence);
+	slot.fence = 0;
+
+	Job& job = slot.job;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!freePixels.empty())
+		{
+			job.pixels.swap(freePixels.back());
+			freePixels.pop_back();
+		}
+	}
+	job.pixels.resize((size_t)Width * Height * 4);
+
+	GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+	void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)job.pixels.size(), GL_MAP_READ_BIT);
+	if (data != NULL)
+	{
+		memcpy(job.pixels.data(), data, job.pixels.size());
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		if (!Enqueue(job))
+			Dropped++;
+	}
+	GLStateCache::Current().BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	job.kind = NO_JOB;
+}
+
+// Hands a job to the encoder thread, returns false if a recorded frame was dropped
+bool FrameCapture::Enqueue(Job& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// Every frame holds a full image, so recorded frames are bounded or a slow disk grows memory without limit
+		if ((job.kind == WRITE_PNG || job.kind == WRITE_Y4M_FRAME) && !job.screenshot && jobs.size() >= MAX_QUEUED_JOBS)
+			return false;
+		jobs.push_back(Job());
+		jobs.back().kind = job.kind;
+		jobs.back().path = job.path;
+		jobs.back().framesPerSecond = job.framesPerSecond;
+		jobs.back().pixels.swap(job.pixels);
+	}
+	wake.notify_one();
+	return true;
+}
+
+// Body of the encoder thread
+void FrameCapture::EncodeLoop()
+{
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return !jobs.empty(); });
+			job.kind = jobs.front().kind;
+			job.path.swap(jobs.front().path);
+			job.framesPerSecond = jobs.front().framesPerSecond;
+			job.pixels.swap(jobs.front().pixels);
+			jobs.pop_front();
+		}
+		if (job.kind == QUIT)
+			break;
+		Encode(job);
+		if (!job.pixels.empty())
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			freePixels.push_back(std::vector<unsigned char>());
+			freePixels.back().swap(job.pixels);
+		}
+	}
+	if (video.is_open())
+		video.close();
+}
+
+// Writes one job on the encoder thread
+void FrameCapture::Encode(Job& job)
+{
+	switch (job.kind)
+	{
+	case WRITE_PNG:
+		if (!write_png(job.path, job.pixels.data(), Width, Height, 4, true))
+			std::cerr << "ERROR: Failed to write capture: " << job.path << std::endl;
+		break;
+	case WRITE_Y4M_FRAME:
+		if (videoPath != job.path)
+		{
+			if (video.is_open())
+				video.close();
+			videoPath = job.path;
+			video.open(job.path.c_str(), std::ios::binary);
+			if (!video)
+			{
+				std::cerr << "ERROR: Failed to open video: " << job.path << std::endl;
+				break;
+			}
+			video << "YUV4MPEG2 W" << Width << " H" << Height << " F" << job.framesPerSecond << ":1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n";
+		}
+		if (video)
+			WriteY4MFrame(job.pixels);
+		break;
+	case CLOSE_VIDEO:
+		if (video.is_open() && videoPath == job.path)
+			video.close();
+		videoPath.clear();
+		break;
+	default:
+		break;
+	}
+}
+
+// Appends one RGBA frame to the open video as 4:2:0 Y'CbCr (full range BT.601)
+void FrameCapture::WriteY4MFrame(const std::vector<unsigned char>& rgba)
+{
+	int chromaWidth = (Width + 1) / 2;
+	int chromaHeight = (Height + 1) / 2;
+	std::vector<unsigned char> planes((size_t)Width * Height + 2 * (size_t)chromaWidth * chromaHeight);
+	unsigned char* yPlane = planes.data();
+	unsigned char* uPlane = yPlane + (size_t)Width * Height;
+	unsigned char* vPlane = uPlane + (size_t)chromaWidth * chromaHeight;
+
+	for (int y = 0; y < Height; y++)
+	{
+		// Framebuffer rows start at the bottom, video rows at the top
+		const unsigned char* row = rgba.data() + (size_t)(Height - 1 - y) * Width * 4;
+		for (int x = 0; x < Width; x++)
+		{
+			const unsigned char* p = row + x * 4;
+			float luma = 0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2];
+			yPlane[(size_t)y * Width + x] = (unsigned char)(luma + 0.5f);
+		}
+	}
+	for (int cy = 0; cy < chromaHeight; cy++)
+	{
+		for (int cx = 0; cx < chromaWidth; cx++)
+		{
+			// Average the 2x2 block, clamped at odd edges
+			float r = 0.0f, g = 0.0f, b = 0.0f;
+			for (int dy = 0; dy < 2; dy++)
+			{
+				int y = cy * 2 + dy < Height ? cy * 2 + dy : Height - 1;
+				const unsigned char* row = rgba.data() + (size_t)(Height - 1 - y) * Width * 4;
+				for (int dx = 0; dx < 2; dx++)
+				{
+					int x = cx * 2 + dx < Width ? cx * 2 + dx : Width - 1;
+					r += row[x * 4];
+					g += row[x * 4 + 1];
+					b += row[x * 4 + 2];
+				}
+			}
+			r *= 0.25f;
+			g *= 0.25f;
+			b *= 0.25f;
+			float u = 128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b;
+			float v = 128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b;
+			uPlane[(size_t)cy * chromaWidth + cx] = (unsigned char)(u < 0.0f ? 0.0f : (u > 255.0f ? 255.0f : u + 0.5f));
+			vPlane[(size_t)cy * chromaWidth + cx] = (unsigned char)(v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v + 0.5f));
+		}
+	}
+	video << "FRAME\n";
+	video.write((const char*)planes.data(), planes.size());
+}
+
+// Writes every pending frame, stops the encoder and deletes the buffers
+void FrameCapture::Delete()
+{
+	if (Recording)
+		StopRecording();
+	for (size_t i = 0; i < slots.size(); i++)
+		Collect(slots[(nextSlot + i) % slots.size()], true);
+
+	Job quit;
+	quit.kind = QUIT;
+	Enqueue(quit);
+	if (encoder.joinable())
+		encoder.join();
+
+	for (size_t i = 0; i < slots.size(); i++)
+	{
+		GLStateCache::Current().ForgetBuffer(slots[i].buffer);
+		glDeleteBuffers(1, &slots[i].buffer);
+	}
+	slots.clear();
+}
@@ -0,0 +1,112 @@
+#include"Header_Files/FrameScheduler.h"
+
+// Marks the scheduler owning window dirty
+static void mark_window_dirty(GLFWwindow* window)
+{
+	FrameScheduler* scheduler = (FrameScheduler*)glfwGetWindowUserPointer(window);
+	if (scheduler != NULL)
+		scheduler->MarkDirty();
+}
+
+// Constructor that installs the input callbacks that mark window dirty
+FrameScheduler::FrameScheduler(GLFWwindow* window, double targetFrameRate)
+{
+	this->window = window;
+	TargetFrameRate = targetFrameRate;
+	IdleTimeout = 0.0;
+	Animating = false;
+	FramesDrawn = 0;
+	IdleWakeups = 0;
+	// The first frame is always drawn
+	dirty = true;
+	lastFrame = -1e9;
+
+	glfwSetWindowUserPointer(window, this);
+	glfwSetKeyCallback(window, OnKey);
+	glfwSetCursorPosCallback(window, OnCursor);
+	glfwSetMouseButtonCallback(window, OnMouseButton);
+	glfwSetScrollCallback(window, OnScroll);
+	glfwSetFramebufferSizeCallback(window, OnResize);
+	glfwSetWindowRefreshCallback(window, OnRefresh);
+	glfwSetWindowFocusCallback(window, OnFocus);
+}
+
+// Requests a redraw; safe from any thread, it wakes the GL thread if it is sleeping
+void FrameScheduler::MarkDirty()
+{
+	dirty = true;
+	glfwPostEmptyEvent();
+}
+
+// Processes events until the next frame is due, returns false once the window should close
+bool FrameScheduler::WaitForFrame()
+{
+	double interval = TargetFrameRate > 0.0 ? 1.0 / TargetFrameRate : 0.0;
+	for (;;)
+	{
+		glfwPollEvents();
+		if (glfwWindowShouldClose(window))
+			return false;
+
+		double now = glfwGetTime();
+		if (Animating || dirty)
+		{
+			double due = lastFrame + interval;
+			if (now >= due)
+			{
+				dirty = false;
+				// Stay on the frame grid unless a whole frame was missed
+				lastFrame = now - due < interval ? due : now;
+				FramesDrawn++;
+				return true;
+			}
+			// Input still wakes this up early, the loop then goes back to waiting for the deadline
+			glfwWaitEventsTimeout(due - now);
+		}
+		else
+		{
+			if (IdleTimeout > 0.0)
+				glfwWaitEventsTimeout(IdleTimeout);
+			else
+				glfwWaitEvents();
+			if (!dirty)
+				IdleWakeups++;
+		}
+	}
+}
+
+// Input and window callbacks, all of them just mark the window dirty
+void FrameScheduler::OnKey(GLFWwindow* window, int, int, int, int)
+{
+	mark_window_dirty(window);
+}
+
+void FrameScheduler::OnCursor(GLFWwindow* window, double, double)
+{
+	mark_window_dirty(window);
+}
+
+void FrameScheduler::OnMouseButton(GLFWwindow* window, int, int, int)
+{
+	mark_window_dirty(window);
+}
+
+void FrameScheduler::OnScroll(GLFWwindow* window, double, double)
+{
+	mark_window_dirty(window);
+}
+
+void FrameScheduler::OnResize(GLFWwindow* window, int, int)
+{
+	mark_window_dirty(window);
+}
+
+void FrameScheduler::OnRefresh(GLFWwindow* window)
+{
+	mark_window_dirty(window);
+}
+
+void FrameScheduler::OnFocus(GLFWwindow* window, int)
+{
+	mark_window_dirty(window);
+}
@@ -0,0 +1,33 @@
+#include"Header_Files/FrameUniforms.h"
+#include"Header_Files/GLStateCache.h"
+
+// Constructor that generates the Uniform Buffer Object and binds it to FRAME_UNIFORMS_BINDING
+FrameUniforms::FrameUniforms()
+{
+	glGenBuffers(1, &ID);
+	GLStateCache::Current().BindBuffer(GL_UNIFORM_BUFFER, ID);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniformData), NULL, GL_DYNAMIC_DRAW);
+	GLStateCache::Current().BindBuffer(GL_UNIFORM_BUFFER, 0);
+	Bind();
+}
+
+// Uploads this frame's data, done once per frame for all programs
+void FrameUniforms::Update(const FrameUniformData& data)
+{
+	GLStateCache::Current().BindBuffer(GL_UNIFORM_BUFFER, ID);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniformData), &data);
+	GLStateCache::Current().BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Binds the buffer to FRAME_UNIFORMS_BINDING
+void FrameUniforms::Bind()
+{
+	GLStateCache::Current().BindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORMS_BINDING, ID);
+}
+
+// Deletes the Uniform Buffer Object
+void FrameUniforms::Delete()
+{
+	GLStateCache::Current().ForgetBuffer(ID);
+	glDeleteBuffers(1, &ID);
+}
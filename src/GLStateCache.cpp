@@ -0,0 +1,205 @@
+#include"Header_Files/GLStateCache.h"
+
+// Value stored for bindings whose state is not known
+static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+// Cache used on this thread, GL contexts are current per thread
+static thread_local GLStateCache* currentCache = NULL;
+
+// Constructor that starts with every binding unknown
+GLStateCache::GLStateCache()
+{
+	Skipped = 0;
+	Invalidate();
+}
+
+// Returns the cache of the context current on this thread
+GLStateCache& GLStateCache::Current()
+{
+	if (currentCache == NULL)
+	{
+		static thread_local GLStateCache fallback;
+		currentCache = &fallback;
+	}
+	return *currentCache;
+}
+
+// Makes cache the one used on this thread, call right after making its context current
+void GLStateCache::MakeCurrent(GLStateCache* cache)
+{
+	currentCache = cache;
+}
+
+// Uses a Shader Program
+void GLStateCache::UseProgram(GLuint program)
+{
+	if (this->program == program)
+	{
+		Skipped++;
+		return;
+	}
+	glUseProgram(program);
+	this->program = program;
+}
+
+// Binds a Vertex Array Object
+void GLStateCache::BindVertexArray(GLuint vao)
+{
+	if (vertexArray == vao)
+	{
+		Skipped++;
+		return;
+	}
+	glBindVertexArray(vao);
+	vertexArray = vao;
+	// The element array binding belongs to the VAO, so it changes with it
+	buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+}
+
+// Binds a buffer to a target
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+{
+	int slot = BufferSlot(target);
+	if (slot >= 0 && buffers[slot] == buffer)
+	{
+		Skipped++;
+		return;
+	}
+	glBindBuffer(target, buffer);
+	if (slot >= 0)
+		buffers[slot] = buffer;
+}
+
+// Binds a buffer to an indexed binding point, which also binds it to the generic target
+void GLStateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	glBindBufferBase(target, index, buffer);
+	int slot = BufferSlot(target);
+	if (slot >= 0)
+		buffers[slot] = buffer;
+}
+
+// Selects the active texture unit (GL_TEXTURE0 + i)
+void GLStateCache::ActiveTexture(GLenum unit)
+{
+	if (activeTexture == unit)
+	{
+		Skipped++;
+		return;
+	}
+	glActiveTexture(unit);
+	activeTexture = unit;
+}
+
+// Binds a texture to a target of the active texture unit
+void GLStateCache::BindTexture(GLenum target, GLuint texture)
+{
+	int slot = TextureSlot(target);
+	GLuint unit = activeTexture - GL_TEXTURE0;
+	if (activeTexture == UNKNOWN || unit >= MAX_TEXTURE_UNITS || slot < 0)
+	{
+		glBindTexture(target, texture);
+		return;
+	}
+	if (textures[unit][slot] == texture)
+	{
+		Skipped++;
+		return;
+	}
+	glBindTexture(target, texture);
+	textures[unit][slot] = texture;
+}
+
+// Makes unit active and binds a texture to it
+void GLStateCache::BindTextureUnit(GLuint unit, GLenum target, GLuint texture)
+{
+	// The unit is switched even when the texture is already bound there, later unit-relative
+	// calls like glTexParameter expect it active; both calls skip what is already set
+	ActiveTexture(GL_TEXTURE0 + unit);
+	BindTexture(target, texture);
+}
+
+// Forgets a program that is about to be deleted
+void GLStateCache::ForgetProgram(GLuint program)
+{
+	// A deleted program stays in use until another one is used, so only forget the name
+	if (this->program == program)
+		this->program = UNKNOWN;
+}
+
+// Forgets a Vertex Array Object that is about to be deleted
+void GLStateCache::ForgetVertexArray(GLuint vao)
+{
+	if (vertexArray == vao)
+	{
+		vertexArray = UNKNOWN;
+		buffers[BufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+	}
+}
+
+// Forgets a buffer that is about to be deleted
+void GLStateCache::ForgetBuffer(GLuint buffer)
+{
+	for (int i = 0; i < BUFFER_TARGETS; i++)
+	{
+		if (buffers[i] == buffer)
+			buffers[i] = UNKNOWN;
+	}
+}
+
+// Forgets a texture that is about to be deleted
+void GLStateCache::ForgetTexture(GLuint texture)
+{
+	for (GLuint unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+	{
+		for (int i = 0; i < TEXTURE_TARGETS; i++)
+		{
+			if (textures[unit][i] == texture)
+				textures[unit][i] = UNKNOWN;
+		}
+	}
+}
+
+// Marks every binding as unknown so the next bind of anything reaches the driver
+void GLStateCache::Invalidate()
+{
+	program = UNKNOWN;
+	vertexArray = UNKNOWN;
+	for (int i = 0; i < BUFFER_TARGETS; i++)
+		buffers[i] = UNKNOWN;
+	activeTexture = UNKNOWN;
+	for (GLuint unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+	{
+		for (int i = 0; i < TEXTURE_TARGETS; i++)
+			textures[unit][i] = UNKNOWN;
+	}
+}
+
+// Maps a buffer target enum to its slot, -1 for targets that are not cached
+int GLStateCache::BufferSlot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER: return 0;
+	case GL_ELEMENT_ARRAY_BUFFER: return 1;
+	case GL_UNIFORM_BUFFER: return 2;
+	case GL_PIXEL_PACK_BUFFER: return 3;
+	case GL_PIXEL_UNPACK_BUFFER: return 4;
+	case GL_COPY_READ_BUFFER: return 5;
+	case GL_COPY_WRITE_BUFFER: return 6;
+	default: return -1;
+	}
+}
+
+// Maps a texture target enum to its slot, -1 for targets that are not cached
+int GLStateCache::TextureSlot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D: return 0;
+	case GL_TEXTURE_2D_ARRAY: return 1;
+	case GL_TEXTURE_3D: return 2;
+	case GL_TEXTURE_CUBE_MAP: return 3;
+	default: return -1;
+	}
+}
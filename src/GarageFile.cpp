@@ -0,0 +1,376 @@
+#include"Header_Files/GarageFile.h"
+#include<cstdint>
+#include<cstdio>
+#include<cstring>
+#include<fstream>
+#include<iostream>
+
+// Identifies layout files and their format version
+static const char GARAGE_MAGIC[8] = { 'P', 'A', 'L', 'G', 'A', 'R', 0, 2 };
+// Every level block and every column in it starts on this boundary
+static const uint64_t GARAGE_ALIGNMENT = 16;
+// Written in the writer's byte order; reads back differently on a machine of the other order
+static const uint32_t GARAGE_BYTE_ORDER = 0x01020304u;
+
+// Columns are used in place, so their elements must have the same size on disk and in memory
+static_assert(sizeof(glm::vec3) == 12 && sizeof(glm::vec2) == 8, "stall columns must be tightly packed");
+static_assert(sizeof(LayoutSegment) == 24, "aisles and ramps must be tightly packed");
+
+// Fixed-size start of a layout file: magic, level count, then the table of contents
+struct GarageHeader
+{
+	char magic[8];
+	uint32_t levelCount;
+	uint32_t byteOrder;
+};
+
+// Table of contents entry, followed by nameLength bytes of name
+struct GarageEntry
+{
+	uint64_t offset;
+	uint64_t size;
+	uint32_t stallCount;
+	uint32_t aisleCount;
+	uint32_t rampCount;
+	uint32_t stringsSize;
+	float bounds[4];
+	uint32_t nameLength;
+	uint32_t reserved;
+};
+
+// Offsets of a level's columns from the start of its block, and the block's size
+struct GarageColumns
+{
+	uint64_t placements, sizes, states, sprites, labels, types, aisles, ramps, strings, end;
+};
+
+// Rounds value up to the next multiple of GARAGE_ALIGNMENT
+static uint64_t align_up(uint64_t value)
+{
+	return (value + GARAGE_ALIGNMENT - 1) & ~(GARAGE_ALIGNMENT - 1);
+}
+
+// Lays out the columns of a level block, the same way for writing and reading
+static GarageColumns garage_columns(uint64_t stalls, uint64_t aisles, uint64_t ramps, uint64_t stringsSize)
+{
+	GarageColumns columns;
+	columns.placements = 0;
+	columns.sizes = align_up(columns.placements + stalls * sizeof(glm::vec3));
+	columns.states = align_up(columns.sizes + stalls * sizeof(glm::vec2));
+	columns.sprites = align_up(columns.states + stalls * sizeof(GLuint));
+	columns.labels = align_up(columns.sprites + stalls * sizeof(GLuint));
+	columns.types = align_up(columns.labels + stalls * sizeof(GLuint));
+	columns.aisles = align_up(columns.types + stalls * sizeof(uint8_t));
+	columns.ramps = align_up(columns.aisles + aisles * sizeof(LayoutSegment));
+	columns.strings = align_up(columns.ramps + ramps * sizeof(LayoutSegment));
+	columns.end = columns.strings + stringsSize;
+	return columns;
+}
+
+// Constructor that creates a closed file
+GarageFile::GarageFile()
+{
+}
+
+// Maps a layout file and reads its table of contents, returns false if it is not one
+bool GarageFile::Open(const std::string& path)
+{
+	Close();
+	if (!file.Open(path))
+	{
+		std::cerr << "ERROR: Failed to open layout file: " << path << std::endl;
+		return false;
+	}
+
+	const GarageHeader* header = (const GarageHeader*)file.Data;
+	if (file.Size < sizeof(GarageHeader) || memcmp(header->magic, GARAGE_MAGIC, sizeof(GARAGE_MAGIC)) != 0)
+	{
+		std::cerr << "ERROR: Not a binary layout file: " << path << std::endl;
+		file.Close();
+		return false;
+	}
+	// Columns are used in place, so the file must have been written in this machine's byte order
+	if (header->byteOrder != GARAGE_BYTE_ORDER)
+	{
+		std::cerr << "ERROR: Layout file was written with another byte order: " << path << std::endl;
+		file.Close();
+		return false;
+	}
+
+	// Only the table is read here, level blocks are checked when first viewed
+	size_t position = sizeof(GarageHeader);
+	for (uint32_t i = 0; i < header->levelCount; i++)
+	{
+		GarageEntry entry;
+		if (position + sizeof(GarageEntry) > file.Size)
+			break;
+		memcpy(&entry, file.Data + position, sizeof(entry));
+		position += sizeof(GarageEntry);
+		if (position + entry.nameLength > file.Size || entry.offset > file.Size || entry.size > file.Size - entry.offset)
+			break;
+		Level level;
+		level.name.assign((const char*)file.Data + position, entry.nameLength);
+		position += entry.nameLength;
+		level.offset = entry.offset;
+		level.size = entry.size;
+		level.stallCount = entry.stallCount;
+		level.aisleCount = entry.aisleCount;
+		level.rampCount = entry.rampCount;
+		level.stringsSize = entry.stringsSize;
+		level.bounds = glm::vec4(entry.bounds[0], entry.bounds[1], entry.bounds[2], entry.bounds[3]);
+		level.checked = false;
+		levels.push_back(level);
+	}
+	if (levels.size() != header->levelCount)
+	{
+		std::cerr << "ERROR: Layout file is truncated: " << path << std::endl;
+		Close();
+		return false;
+	}
+	return true;
+}
+
+// Returns true while a file is open
+bool GarageFile::IsOpen() const
+{
+	return file.IsOpen();
+}
+
+// Number of levels in the file
+int GarageFile::Levels() const
+{
+	return (int)levels.size();
+}
+
+// Returns the name of a level
+const std::string& GarageFile::LevelName(int level) const
+{
+	return levels[level].name;
+}
+
+// Returns the number of stalls on a level without reading its block
+GLuint GarageFile::StallCount(int level) const
+{
+	return levels[level].stallCount;
+}
+
+// Points view at a level's columns inside the mapping, returns false if its block is damaged
+bool GarageFile::View(int level, GarageLevelView& view)
+{
+	Level& source = levels[level];
+	GarageColumns columns = garage_columns(source.stallCount, source.aisleCount, source.rampCount, source.stringsSize);
+	if (!source.checked)
+	{
+		// The columns must fit the block and be aligned in memory; the strings must end in a terminator
+		const unsigned char* block = file.Data + source.offset;
+		bool fits = columns.end <= source.size && ((uintptr_t)block & (GARAGE_ALIGNMENT - 1)) == 0;
+		if (!fits || (source.stringsSize > 0 && block[columns.strings + source.stringsSize - 1] != '\0'))
+		{
+			std::cerr << "ERROR: Layout file level is damaged: " << source.name << std::endl;
+			return false;
+		}
+		source.checked = true;
+	}
+
+	const unsigned char* block = file.Data + source.offset;
+	view.stallCount = source.stallCount;
+	view.placements = (const glm::vec3*)(block + columns.placements);
+	view.sizes = (const glm::vec2*)(block + columns.sizes);
+	view.states = (const GLuint*)(block + columns.states);
+	view.sprites = (const GLuint*)(block + columns.sprites);
+	view.labels = (const GLuint*)(block + columns.labels);
+	view.types = (const uint8_t*)(block + columns.types);
+	view.aisleCount = source.aisleCount;
+	view.rampCount = source.rampCount;
+	view.aisles = (const LayoutSegment*)(block + columns.aisles);
+	view.ramps = (const LayoutSegment*)(block + columns.ramps);
+	view.strings = (const char*)(block + columns.strings);
+	view.stringsSize = source.stringsSize;
+	view.bounds = source.bounds;
+	return true;
+}
+
+// Copies a level into layout as a new level, returns false if its block is damaged
+bool GarageFile::Load(int level, GarageLayout& layout)
+{
+	GarageLevelView view;
+	if (!View(level, view))
+		return false;
+	Copy(view, layout, layout.AddLevel(levels[level].name));
+	return true;
+}
+
+// Replaces layout with one empty level per level of the file, named like them, without reading any block
+void GarageFile::Outline(GarageLayout& layout) const
+{
+	layout.Clear();
+	for (size_t i = 0; i < levels.size(); i++)
+		layout.AddLevel(levels[i].name);
+}
+
+// Copies a level into the same level of a layout made by Outline, returns false if its block is damaged
+bool GarageFile::Fill(int level, GarageLayout& layout)
+{
+	GarageLevelView view;
+	if (!View(level, view))
+		return false;
+	Copy(view, layout, level);
+	return true;
+}
+
+// Copies the columns of view into a level of layout
+void GarageFile::Copy(const GarageLevelView& view, GarageLayout& layout, int level)
+{
+	// Whole columns are copied at once, only the labels are moved to where the strings land in the arena
+	GLuint stringsStart = layout.AddStrings(view.strings, view.stringsSize);
+	GarageLevel& target = layout.Levels[level];
+	GLuint count = view.stallCount;
+	target.placements.assign(view.placements, view.placements + count);
+	target.sizes.assign(view.sizes, view.sizes + count);
+	target.states.assign(view.states, view.states + count);
+	target.sprites.assign(view.sprites, view.sprites + count);
+	target.types.assign(view.types, view.types + count);
+	target.labels.resize(count);
+	for (GLuint i = 0; i < count; i++)
+		target.labels[i] = view.labels[i] < view.stringsSize ? stringsStart + view.labels[i] : NO_LABEL;
+	target.aisles.assign(view.aisles, view.aisles + view.aisleCount);
+	target.ramps.assign(view.ramps, view.ramps + view.rampCount);
+}
+
+// Unmaps the file, earlier views become invalid
+void GarageFile::Close()
+{
+	levels.clear();
+	file.Close();
+}
+
+// Returns true if path starts like a binary layout file
+bool GarageFile::Detect(const std::string& path)
+{
+	std::ifstream in(path.c_str(), std::ios::binary);
+	char magic[sizeof(GARAGE_MAGIC)];
+	return in.read(magic, sizeof(magic)) && memcmp(magic, GARAGE_MAGIC, sizeof(magic)) == 0;
+}
+
+// Writes every level of layout into a binary layout file, returns false if it cannot be written
+bool GarageFile::Write(const std::string& path, const GarageLayout& layout)
+{
+	std::vector<std::string> names;
+	std::vector<GarageLevelView> views;
+	for (size_t i = 0; i < layout.Levels.size(); i++)
+	{
+		names.push_back(layout.String(layout.Levels[i].name));
+		views.push_back(layout.View((int)i));
+	}
+	return Write(path, names, views);
+}
+
+// Writes levels, wherever their columns are stored, into a binary layout file; returns false if it cannot be written
+bool GarageFile::Write(const std::string& path, const std::vector<std::string>& names, const std::vector<GarageLevelView>& views)
+{
+	// Each level carries its own labels, so a level can be loaded without the others' strings
+	size_t levelCount = views.size();
+	std::vector<std::vector<char> > strings(levelCount);
+	std::vector<std::vector<GLuint> > labels(levelCount);
+	for (size_t i = 0; i < levelCount; i++)
+	{
+		const GarageLevelView& level = views[i];
+		labels[i].resize(level.stallCount);
+		for (GLuint s = 0; s < level.stallCount; s++)
+		{
+			if (level.labels[s] >= level.stringsSize)
+			{
+				labels[i][s] = NO_LABEL;
+				continue;
+			}
+			const char* label = level.Label(s);
+			labels[i][s] = (GLuint)strings[i].size();
+			strings[i].insert(strings[i].end(), label, label + strlen(label) + 1);
+		}
+	}
+
+	// Lay the level blocks out after the table of contents
+	GarageHeader header;
+	memcpy(header.magic, GARAGE_MAGIC, sizeof(GARAGE_MAGIC));
+	header.levelCount = (uint32_t)levelCount;
+	header.byteOrder = GARAGE_BYTE_ORDER;
+	uint64_t offset = sizeof(GarageHeader);
+	for (size_t i = 0; i < levelCount; i++)
+		offset += sizeof(GarageEntry) + names[i].size();
+	std::vector<GarageEntry> table(levelCount);
+	std::vector<GarageColumns> columns(levelCount);
+	for (size_t i = 0; i < levelCount; i++)
+	{
+		const GarageLevelView& level = views[i];
+		columns[i] = garage_columns(level.stallCount, level.aisleCount, level.rampCount, strings[i].size());
+		offset = align_up(offset);
+		table[i].offset = offset;
+		table[i].size = columns[i].end;
+		table[i].stallCount = level.stallCount;
+		table[i].aisleCount = level.aisleCount;
+		table[i].rampCount = level.rampCount;
+		table[i].stringsSize = (uint32_t)strings[i].size();
+		for (int k = 0; k < 4; k++)
+			table[i].bounds[k] = level.bounds[k];
+		table[i].nameLength = (uint32_t)names[i].size();
+		table[i].reserved = 0;
+		offset += columns[i].end;
+	}
+
+	// Write to a temporary name first so a crash never leaves a truncated file behind;
+	// the temporary file is removed again whenever the write or the rename fails
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream out(temporary.c_str(), std::ios::binary);
+		if (!out)
+		{
+			std::cerr << "ERROR: Failed to write layout file: " << path << std::endl;
+			return false;
+		}
+		out.write((const char*)&header, sizeof(header));
+		for (size_t i = 0; i < levelCount; i++)
+		{
+			out.write((const char*)&table[i], sizeof(GarageEntry));
+			out.write(names[i].data(), table[i].nameLength);
+		}
+		static const char zeros[GARAGE_ALIGNMENT] = { 0 };
+		for (size_t i = 0; i < levelCount; i++)
+		{
+			const GarageLevelView& level = views[i];
+			uint64_t start = table[i].offset;
+			// Pads up to where a column starts, then writes it
+			auto column = [&](uint64_t at, const void* data, size_t size)
+			{
+				uint64_t position = (uint64_t)out.tellp();
+				out.write(zeros, (std::streamsize)(start + at - position));
+				if (size > 0)
+					out.write((const char*)data, (std::streamsize)size);
+			};
+			size_t count = level.stallCount;
+			column(columns[i].placements, level.placements, count * sizeof(glm::vec3));
+			column(columns[i].sizes, level.sizes, count * sizeof(glm::vec2));
+			column(columns[i].states, level.states, count * sizeof(GLuint));
+			column(columns[i].sprites, level.sprites, count * sizeof(GLuint));
+			column(columns[i].labels, labels[i].data(), count * sizeof(GLuint));
+			column(columns[i].types, level.types, count * sizeof(uint8_t));
+			column(columns[i].aisles, level.aisles, level.aisleCount * sizeof(LayoutSegment));
+			column(columns[i].ramps, level.ramps, level.rampCount * sizeof(LayoutSegment));
+			column(columns[i].strings, strings[i].data(), strings[i].size());
+		}
+		out.close();
+		if (!out)
+		{
+			std::cerr << "ERROR: Failed to write layout file: " << path << std::endl;
+			remove(temporary.c_str());
+			return false;
+		}
+	}
+	remove(path.c_str());
+	if (rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		std::cerr << "ERROR: Failed to replace layout file: " << path << std::endl;
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,195 @@
+#include"Header_Files/GarageLayout.h"
+#include<algorithm>
+#include<cfloat>
+#include<cmath>
+
+// Number of stalls on the level
+size_t GarageLevel::StallCount() const
+{
+	return placements.size();
+}
+
+// Bounds (min x, min y, max x, max y) of every stall, 0..1 for a level without stalls
+glm::vec4 GarageLevel::Bounds() const
+{
+	if (placements.empty())
+		return glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	glm::vec2 minimum(FLT_MAX), maximum(-FLT_MAX);
+	for (size_t i = 0; i < placements.size(); i++)
+	{
+		// Half the diagonal bounds the stall whatever its rotation
+		float radius = 0.5f * glm::length(sizes[i]);
+		glm::vec2 center(placements[i]);
+		minimum = glm::min(minimum, center - radius);
+		maximum = glm::max(maximum, center + radius);
+	}
+	return glm::vec4(minimum, maximum);
+}
+
+// Returns the label of a stall, "" for none
+const char* GarageLevelView::Label(GLuint stall) const
+{
+	GLuint offset = labels[stall];
+	return offset < stringsSize ? strings + offset : "";
+}
+
+// Constructor that creates an empty layout
+GarageLayout::GarageLayout()
+{
+}
+
+// Copies text into the arena and returns its offset
+GLuint GarageLayout::Intern(const std::string& text)
+{
+	GLuint offset = (GLuint)arena.size();
+	arena.insert(arena.end(), text.begin(), text.end());
+	arena.push_back('\0');
+	return offset;
+}
+
+// Adds a level and returns its index
+int GarageLayout::AddLevel(const std::string& name)
+{
+	GarageLevel level;
+	level.name = Intern(name);
+	Levels.push_back(level);
+	return (int)Levels.size() - 1;
+}
+
+// Makes room for stalls more stalls on a level, so bulk loads grow every column once
+void GarageLayout::Reserve(int level, size_t stalls)
+{
+	GarageLevel& target = Levels[level];
+	size_t count = target.StallCount() + stalls;
+	target.placements.reserve(count);
+	target.sizes.reserve(count);
+	target.states.reserve(count);
+	target.sprites.reserve(count);
+	target.types.reserve(count);
+	target.labels.reserve(count);
+}
+
+// Adds a stall to a level and returns its index there
+GLuint GarageLayout::AddStall(int level, const StallInstance& stall, uint8_t type, const std::string& label)
+{
+	GarageLevel& target = Levels[level];
+	target.placements.push_back(glm::vec3(stall.x, stall.y, stall.angle));
+	target.sizes.push_back(glm::vec2(stall.width, stall.depth));
+	target.states.push_back(stall.state);
+	target.sprites.push_back(stall.sprite);
+	target.types.push_back(type);
+	target.labels.push_back(label.empty() ? NO_LABEL : Intern(label));
+	return (GLuint)target.StallCount() - 1;
+}
+
+// Adds an aisle to a level
+void GarageLayout::AddAisle(int level, glm::vec2 from, glm::vec2 to, float width)
+{
+	LayoutSegment aisle;
+	aisle.from = from;
+	aisle.to = to;
+	aisle.width = width;
+	aisle.toLevel = -1;
+	Levels[level].aisles.push_back(aisle);
+}
+
+// Adds a ramp from a level to toLevel
+void GarageLayout::AddRamp(int level, glm::vec2 from, glm::vec2 to, float width, int toLevel)
+{
+	LayoutSegment ramp;
+	ramp.from = from;
+	ramp.to = to;
+	ramp.width = width;
+	ramp.toLevel = toLevel;
+	Levels[level].ramps.push_back(ramp);
+}
+
+// Sets the state of a stall
+void GarageLayout::SetState(int level, GLuint stall, GLuint state)
+{
+	Levels[level].states[stall] = state;
+}
+
+// Returns a stall as one record
+StallInstance GarageLayout::Stall(int level, GLuint stall) const
+{
+	const GarageLevel& source = Levels[level];
+	StallInstance record;
+	record.x = source.placements[stall].x;
+	record.y = source.placements[stall].y;
+	record.angle = source.placements[stall].z;
+	record.width = source.sizes[stall].x;
+	record.depth = source.sizes[stall].y;
+	record.state = source.states[stall];
+	record.sprite = source.sprites[stall];
+	return record;
+}
+
+// Replaces stalls with the records of every stall on a level
+void GarageLayout::Instances(int level, std::vector<StallInstance>& stalls) const
+{
+	stalls.resize(Levels[level].StallCount());
+	for (size_t i = 0; i < stalls.size(); i++)
+		stalls[i] = Stall(level, (GLuint)i);
+}
+
+// Number of stalls on every level together
+size_t GarageLayout::StallCount() const
+{
+	size_t count = 0;
+	for (size_t i = 0; i < Levels.size(); i++)
+		count += Levels[i].StallCount();
+	return count;
+}
+
+// Number of stalls in state on every level together
+size_t GarageLayout::CountState(GLuint state) const
+{
+	size_t count = 0;
+	for (size_t i = 0; i < Levels.size(); i++)
+		count += std::count(Levels[i].states.begin(), Levels[i].states.end(), state);
+	return count;
+}
+
+// Returns a name or label by its arena offset, "" for NO_LABEL
+const char* GarageLayout::String(GLuint offset) const
+{
+	return offset < arena.size() ? &arena[offset] : "";
+}
+
+// Copies a block of zero-terminated strings into the arena and returns the offset it starts at
+GLuint GarageLayout::AddStrings(const char* strings, size_t size)
+{
+	GLuint offset = (GLuint)arena.size();
+	arena.insert(arena.end(), strings, strings + size);
+	return offset;
+}
+
+// Returns a view of a level's columns, valid until the layout changes
+GarageLevelView GarageLayout::View(int level) const
+{
+	const GarageLevel& source = Levels[level];
+	GarageLevelView view;
+	view.stallCount = (GLuint)source.StallCount();
+	view.placements = source.placements.data();
+	view.sizes = source.sizes.data();
+	view.states = source.states.data();
+	view.sprites = source.sprites.data();
+	view.types = source.types.data();
+	view.labels = source.labels.data();
+	view.aisleCount = (GLuint)source.aisles.size();
+	view.rampCount = (GLuint)source.ramps.size();
+	view.aisles = source.aisles.data();
+	view.ramps = source.ramps.data();
+	view.strings = arena.data();
+	view.stringsSize = (GLuint)arena.size();
+	view.bounds = source.Bounds();
+	return view;
+}
+
+// Removes every level
+void GarageLayout::Clear()
+{
+	Levels.clear();
+	arena.clear();
+}
@@ -0,0 +1,85 @@
+#include"Header_Files/GarageSite.h"
+#include<fstream>
+#include<iostream>
+#include<sstream>
+
+// Constructor with common metric stall and aisle sizes
+GarageSite::GarageSite()
+{
+	columnOrigin = glm::vec2(0.0f);
+	columnSpacing = glm::vec2(0.0f);
+	columnSize = 0.0f;
+	entryClearance = 6.0f;
+	stallWidth = 2.5f;
+	stallDepth = 5.0f;
+	// Two-way aisles for right-angled stalls, one-way for angled ones
+	aisleWidths[0] = 7.0f;
+	aisleWidths[1] = 5.5f;
+	aisleWidths[2] = 4.0f;
+}
+
+// Reads a text site file for LayoutGenerator
+bool load_garage_site(const std::string& path, GarageSite& site)
+{
+	std::ifstream in(path.c_str());
+	if (!in)
+	{
+		std::cerr << "ERROR: Failed to open site file: " << path << std::endl;
+		return false;
+	}
+
+	site = GarageSite();
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(in, line))
+	{
+		lineNumber++;
+		size_t first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos || line[first] == '#')
+			continue;
+
+		std::istringstream fields(line);
+		std::string keyword;
+		fields >> keyword;
+		bool parsed = true;
+		if (keyword == "footprint")
+		{
+			glm::vec2 point;
+			while (fields >> point.x >> point.y)
+				site.footprint.push_back(point);
+		}
+		else if (keyword == "columns")
+			parsed = (bool)(fields >> site.columnOrigin.x >> site.columnOrigin.y >> site.columnSpacing.x >> site.columnSpacing.y >> site.columnSize);
+		else if (keyword == "ramp")
+		{
+			LayoutSegment ramp;
+			parsed = (bool)(fields >> ramp.from.x >> ramp.from.y >> ramp.to.x >> ramp.to.y >> ramp.width >> ramp.toLevel);
+			site.ramps.push_back(ramp);
+		}
+		else if (keyword == "entry")
+		{
+			glm::vec2 entry;
+			parsed = (bool)(fields >> entry.x >> entry.y);
+			site.entries.push_back(entry);
+		}
+		else if (keyword == "clearance")
+			parsed = (bool)(fields >> site.entryClearance);
+		else if (keyword == "stall")
+			parsed = (bool)(fields >> site.stallWidth >> site.stallDepth);
+		else if (keyword == "aisles")
+			parsed = (bool)(fields >> site.aisleWidths[0] >> site.aisleWidths[1] >> site.aisleWidths[2]);
+		else
+			parsed = false;
+		if (!parsed)
+		{
+			std::cerr << "ERROR: " << path << ":" << lineNumber << ": expected footprint, columns, ramp, entry, clearance, stall or aisles" << std::endl;
+			return false;
+		}
+	}
+	if (site.footprint.size() < 3)
+	{
+		std::cerr << "ERROR: " << path << ": footprint needs at least three points" << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,268 @@
+#include"Header_Files/ImageWriter.h"
+#include<algorithm>
+#include<cstdint>
+#include<cstdlib>
+#include<fstream>
+#include<vector>
+
+// Appends bits least significant first, as deflate expects
+struct BitWriter
+{
+	std::vector<unsigned char>& out;
+	uint32_t buffer;
+	int count;
+
+	BitWriter(std::vector<unsigned char>& out) : out(out), buffer(0), count(0) {}
+
+	void Write(uint32_t bits, int length)
+	{
+		buffer |= bits << count;
+		count += length;
+		while (count >= 8)
+		{
+			out.push_back((unsigned char)(buffer & 0xFF));
+			buffer >>= 8;
+			count -= 8;
+		}
+	}
+
+	// Huffman codes are defined most significant bit first, so they go out reversed
+	void WriteCode(uint32_t code, int length)
+	{
+		uint32_t reversed = 0;
+		for (int i = 0; i < length; i++)
+			reversed |= ((code >> i) & 1) << (length - 1 - i);
+		Write(reversed, length);
+	}
+
+	void Flush()
+	{
+		if (count > 0)
+			out.push_back((unsigned char)(buffer & 0xFF));
+		buffer = 0;
+		count = 0;
+	}
+};
+
+// Writes a literal or length symbol with the fixed Huffman code of deflate
+static void write_fixed_symbol(BitWriter& bits, int symbol)
+{
+	if (symbol < 144)
+		bits.WriteCode(0x30 + symbol, 8);
+	else if (symbol < 256)
+		bits.WriteCode(0x190 + symbol - 144, 9);
+	else if (symbol < 280)
+		bits.WriteCode(symbol - 256, 7);
+	else
+		bits.WriteCode(0xC0 + symbol - 280, 8);
+}
+
+// Length and distance bases from the deflate specification
+static const int LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const int LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const int DIST_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const int DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// Compresses data into a zlib stream using one fixed Huffman block and a hashed LZ77 search
+static void zlib_compress(const std::vector<unsigned char>& data, std::vector<unsigned char>& out)
+{
+	const int WINDOW = 32768;
+	const int HASH_SIZE = 1 << 15;
+	const int MAX_CHAIN = 16;
+	const int MIN_MATCH = 3;
+	const int MAX_MATCH = 258;
+
+	out.push_back(0x78);
+	out.push_back(0x01);
+	BitWriter bits(out);
+	// BFINAL = 1, BTYPE = 01 (fixed Huffman)
+	bits.Write(1, 1);
+	bits.Write(1, 2);
+
+	std::vector<int> head(HASH_SIZE, -1);
+	std::vector<int> prev(data.size(), -1);
+	size_t n = data.size();
+	size_t i = 0;
+	while (i < n)
+	{
+		int bestLength = 0;
+		int bestDistance = 0;
+		if (i + MIN_MATCH <= n)
+		{
+			uint32_t hash = ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & (HASH_SIZE - 1);
+			int candidate = head[hash];
+			for (int chain = 0; candidate >= 0 && chain < MAX_CHAIN; chain++)
+			{
+				if ((int)i - candidate > WINDOW)
+					break;
+				int length = 0;
+				int limit = (int)std::min((size_t)MAX_MATCH, n - i);
+				while (length < limit && data[candidate + length] == data[i + length])
+					length++;
+				if (length > bestLength)
+				{
+					bestLength = length;
+					bestDistance = (int)i - candidate;
+					if (length == limit)
+						break;
+				}
+				candidate = prev[candidate];
+			}
+			prev[i] = head[hash];
+			head[hash] = (int)i;
+		}
+
+		if (bestLength >= MIN_MATCH)
+		{
+			int code = 0;
+			while (code < 28 && LENGTH_BASE[code + 1] <= bestLength)
+				code++;
+			write_fixed_symbol(bits, 257 + code);
+			bits.Write(bestLength - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+			int dist = 0;
+			while (dist < 29 && DIST_BASE[dist + 1] <= bestDistance)
+				dist++;
+			bits.WriteCode(dist, 5);
+			bits.Write(bestDistance - DIST_BASE[dist], DIST_EXTRA[dist]);
+
+			// Keep the hash chains complete across the matched bytes
+			for (size_t j = i + 1; j < i + bestLength && j + MIN_MATCH <= n; j++)
+			{
+				uint32_t hash = ((data[j] << 10) ^ (data[j + 1] << 5) ^ data[j + 2]) & (HASH_SIZE - 1);
+				prev[j] = head[hash];
+				head[hash] = (int)j;
+			}
+			i += bestLength;
+		}
+		else
+		{
+			write_fixed_symbol(bits, data[i]);
+			i++;
+		}
+	}
+	write_fixed_symbol(bits, 256);
+	bits.Flush();
+
+	uint32_t a = 1, b = 0;
+	for (size_t k = 0; k < n; k++)
+	{
+		a = (a + data[k]) % 65521;
+		b = (b + a) % 65521;
+	}
+	uint32_t adler = (b << 16) | a;
+	for (int shift = 24; shift >= 0; shift -= 8)
+		out.push_back((unsigned char)(adler >> shift));
+}
+
+// Builds the CRC-32 lookup table used by PNG chunks
+static std::vector<uint32_t> make_crc_table()
+{
+	std::vector<uint32_t> table(256);
+	for (uint32_t n = 0; n < 256; n++)
+	{
+		uint32_t c = n;
+		for (int k = 0; k < 8; k++)
+			c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+		table[n] = c;
+	}
+	return table;
+}
+
+// CRC-32 as used by PNG chunks
+static uint32_t png_crc32(const unsigned char* data, size_t length)
+{
+	static const std::vector<uint32_t> table = make_crc_table();
+	uint32_t crc = 0xFFFFFFFFu;
+	for (size_t i = 0; i < length; i++)
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+// Appends a big-endian 32-bit value
+static void put_u32(std::vector<unsigned char>& out, uint32_t value)
+{
+	for (int shift = 24; shift >= 0; shift -= 8)
+		out.push_back((unsigned char)(value >> shift));
+}
+
+// Appends a PNG chunk with its length and CRC
+static void put_chunk(std::vector<unsigned char>& out, const char* type, const std::vector<unsigned char>& data)
+{
+	put_u32(out, (uint32_t)data.size());
+	size_t start = out.size();
+	out.insert(out.end(), type, type + 4);
+	out.insert(out.end(), data.begin(), data.end());
+	put_u32(out, png_crc32(&out[start], out.size() - start));
+}
+
+// Writes 8-bit pixels with 1 to 4 channels as a PNG file
+bool write_png(const std::string& path, const unsigned char* pixels, int width, int height, int channels, bool flipVertically)
+{
+	if (channels < 1 || channels > 4 || width <= 0 || height <= 0)
+		return false;
+
+	// Filter each row with whichever of None, Sub and Up gives the smallest residuals
+	size_t stride = (size_t)width * channels;
+	std::vector<unsigned char> filtered;
+	filtered.reserve((stride + 1) * height);
+	std::vector<unsigned char> candidate[3];
+	for (int y = 0; y < height; y++)
+	{
+		int srcRow = flipVertically ? height - 1 - y : y;
+		int prevRow = flipVertically ? srcRow + 1 : srcRow - 1;
+		const unsigned char* row = pixels + srcRow * stride;
+		const unsigned char* above = y > 0 ? pixels + prevRow * stride : NULL;
+
+		long bestScore = -1;
+		int bestFilter = 0;
+		for (int f = 0; f < 3; f++)
+		{
+			candidate[f].resize(stride);
+			long score = 0;
+			for (size_t x = 0; x < stride; x++)
+			{
+				unsigned char left = x >= (size_t)channels ? row[x - channels] : 0;
+				unsigned char up = above != NULL ? above[x] : 0;
+				unsigned char value = row[x];
+				if (f == 1)
+					value = (unsigned char)(value - left);
+				else if (f == 2)
+					value = (unsigned char)(value - up);
+				candidate[f][x] = value;
+				score += value < 128 ? value : 256 - value;
+			}
+			if (bestScore < 0 || score < bestScore)
+			{
+				bestScore = score;
+				bestFilter = f;
+			}
+		}
+		filtered.push_back((unsigned char)bestFilter);
+		filtered.insert(filtered.end(), candidate[bestFilter].begin(), candidate[bestFilter].end());
+	}
+
+	static const unsigned char COLOR_TYPES[5] = { 0, 0, 4, 2, 6 };
+	std::vector<unsigned char> header;
+	put_u32(header, (uint32_t)width);
+	put_u32(header, (uint32_t)height);
+	header.push_back(8);
+	header.push_back(COLOR_TYPES[channels]);
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+
+	std::vector<unsigned char> compressed;
+	zlib_compress(filtered, compressed);
+
+	static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	std::vector<unsigned char> file(SIGNATURE, SIGNATURE + 8);
+	put_chunk(file, "IHDR", header);
+	put_chunk(file, "IDAT", compressed);
+	put_chunk(file, "IEND", std::vector<unsigned char>());
+
+	std::ofstream out(path.c_str(), std::ios::binary);
+	if (!out)
+		return false;
+	out.write((const char*)file.data(), file.size());
+	return (bool)out;
+}
@@ -0,0 +1,156 @@
+#include"Header_Files/LayoutFile.h"
+#include"Header_Files/GarageFile.h"
+#include<cctype>
+#include<fstream>
+#include<iostream>
+#include<sstream>
+
+// Longest stall label accepted, labels are painted on the stall and kept in the string arena
+static const size_t MAX_LABEL_LENGTH = 32;
+
+// Reads a text layout file into a GarageLayout
+bool load_garage_layout(const std::string& path, GarageLayout& layout)
+{
+	if (GarageFile::Detect(path))
+	{
+		GarageFile file;
+		if (!file.Open(path))
+			return false;
+		layout.Clear();
+		bool loaded = true;
+		for (int i = 0; i < file.Levels() && loaded; i++)
+			loaded = file.Load(i, layout);
+		file.Close();
+		return loaded;
+	}
+
+	std::ifstream in(path.c_str());
+	if (!in)
+	{
+		std::cerr << "ERROR: Failed to open layout file: " << path << std::endl;
+		return false;
+	}
+
+	layout.Clear();
+	int level = -1;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(in, line))
+	{
+		lineNumber++;
+		size_t first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos || line[first] == '#')
+			continue;
+
+		std::istringstream fields(line);
+		if (isalpha((unsigned char)line[first]))
+		{
+			std::string keyword;
+			fields >> keyword;
+			if (keyword == "level")
+			{
+				std::string name;
+				std::getline(fields >> std::ws, name);
+				level = layout.AddLevel(name.empty() ? std::to_string(layout.Levels.size() + 1) : name);
+				continue;
+			}
+			glm::vec2 from, to;
+			float width;
+			int toLevel = -1;
+			bool ramp = keyword == "ramp";
+			if ((keyword != "aisle" && !ramp) || !(fields >> from.x >> from.y >> to.x >> to.y >> width) || (ramp && !(fields >> toLevel)))
+			{
+				std::cerr << "ERROR: " << path << ":" << lineNumber << ": expected level, aisle or ramp" << std::endl;
+				return false;
+			}
+			if (level < 0)
+				level = layout.AddLevel("1");
+			if (ramp)
+				layout.AddRamp(level, from, to, width, toLevel);
+			else
+				layout.AddAisle(level, from, to, width);
+			continue;
+		}
+
+		StallInstance stall;
+		float angleDegrees = 0.0f;
+		if (!(fields >> stall.x >> stall.y >> angleDegrees >> stall.width >> stall.depth >> stall.state))
+		{
+			std::cerr << "ERROR: " << path << ":" << lineNumber << ": expected x y angle width depth state" << std::endl;
+			return false;
+		}
+		stall.angle = angleDegrees * 0.017453292f;
+		int sprite = -1;
+		int type = STALL_STANDARD;
+		std::string label;
+		fields >> sprite >> type >> label;
+		if (type < STALL_STANDARD || type > STALL_EV)
+		{
+			std::cerr << "ERROR: " << path << ":" << lineNumber << ": unknown stall type " << type << std::endl;
+			return false;
+		}
+		if (label.size() > MAX_LABEL_LENGTH)
+		{
+			std::cerr << "ERROR: " << path << ":" << lineNumber << ": label longer than " << MAX_LABEL_LENGTH << " characters" << std::endl;
+			return false;
+		}
+		stall.sprite = sprite < 0 ? NO_SPRITE : (GLuint)sprite;
+		if (level < 0)
+			level = layout.AddLevel("1");
+		layout.AddStall(level, stall, (uint8_t)type, label);
+	}
+	return true;
+}
+
+// Writes a GarageLayout as a text layout file that load_garage_layout reads back
+bool save_garage_layout(const std::string& path, const GarageLayout& layout)
+{
+	std::vector<std::string> names;
+	std::vector<GarageLevelView> views;
+	for (size_t i = 0; i < layout.Levels.size(); i++)
+	{
+		names.push_back(layout.String(layout.Levels[i].name));
+		views.push_back(layout.View((int)i));
+	}
+	return save_garage_levels(path, names, views);
+}
+
+// Writes levels, wherever their columns are stored, as a text layout file
+bool save_garage_levels(const std::string& path, const std::vector<std::string>& names, const std::vector<GarageLevelView>& views)
+{
+	std::ofstream out(path.c_str());
+	if (!out)
+	{
+		std::cerr << "ERROR: Failed to write layout file: " << path << std::endl;
+		return false;
+	}
+
+	// Enough digits that every float reads back to the same value
+	out.precision(9);
+	for (size_t i = 0; i < views.size(); i++)
+	{
+		const GarageLevelView& level = views[i];
+		out << "level " << names[i] << "\n";
+		for (GLuint s = 0; s < level.stallCount; s++)
+		{
+			const glm::vec3& placement = level.placements[s];
+			out << placement.x << " " << placement.y << " " << placement.z / 0.017453292f << " "
+				<< level.sizes[s].x << " " << level.sizes[s].y << " " << level.states[s] << " "
+				<< (level.sprites[s] == NO_SPRITE ? -1 : (long long)level.sprites[s]) << " " << (int)level.types[s];
+			if (level.labels[s] < level.stringsSize)
+				out << " " << level.Label(s);
+			out << "\n";
+		}
+		for (GLuint a = 0; a < level.aisleCount; a++)
+		{
+			const LayoutSegment& aisle = level.aisles[a];
+			out << "aisle " << aisle.from.x << " " << aisle.from.y << " " << aisle.to.x << " " << aisle.to.y << " " << aisle.width << "\n";
+		}
+		for (GLuint r = 0; r < level.rampCount; r++)
+		{
+			const LayoutSegment& ramp = level.ramps[r];
+			out << "ramp " << ramp.from.x << " " << ramp.from.y << " " << ramp.to.x << " " << ramp.to.y << " " << ramp.width << " " << ramp.toLevel << "\n";
+		}
+	}
+	return (bool)out;
+}
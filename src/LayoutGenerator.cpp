@@ -0,0 +1,469 @@
+#include"Header_Files/LayoutGenerator.h"
+#include"Header_Files/StallGeometry.h"
+#include<glm/gtc/constants.hpp>
+#include<algorithm>
+#include<cfloat>
+#include<cmath>
+#include<cstring>
+
+// Gap below which shapes count as touching rather than overlapping
+static const float EPSILON = 1e-3f;
+
+// Next value of a splitmix64 sequence; used instead of <random> so every platform draws the same numbers
+static uint64_t next_random(uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// Uniform float in [0, 1)
+static float random_unit(uint64_t& state)
+{
+	return (float)(next_random(state) >> 40) / (float)(1ull << 24);
+}
+
+// Uniform integer in [0, count)
+static int random_below(uint64_t& state, int count)
+{
+	return (int)(next_random(state) % (uint64_t)count);
+}
+
+// Returns true if point is inside polygon (even-odd rule)
+static bool point_in_polygon(const std::vector<glm::vec2>& polygon, glm::vec2 point)
+{
+	bool inside = false;
+	for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+	{
+		const glm::vec2& a = polygon[i];
+		const glm::vec2& b = polygon[j];
+		if ((a.y > point.y) != (b.y > point.y) && point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x)
+			inside = !inside;
+	}
+	return inside;
+}
+
+// Returns the z of the cross product of b - a and c - a
+static float cross(glm::vec2 a, glm::vec2 b, glm::vec2 c)
+{
+	return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+// Returns true if segments ab and cd cross at a point inside both
+static bool segments_cross(glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 d)
+{
+	float d1 = cross(c, d, a), d2 = cross(c, d, b);
+	float d3 = cross(a, b, c), d4 = cross(a, b, d);
+	return ((d1 > EPSILON && d2 < -EPSILON) || (d1 < -EPSILON && d2 > EPSILON)) &&
+		((d3 > EPSILON && d4 < -EPSILON) || (d3 < -EPSILON && d4 > EPSILON));
+}
+
+// Returns true if two rectangles, given by their corners in order, overlap by more than EPSILON
+static bool rects_overlap(const glm::vec2* a, const glm::vec2* b)
+{
+	// Separating axis test on the two edge directions of each rectangle
+	const glm::vec2* rects[2] = { a, b };
+	for (int r = 0; r < 2; r++)
+	{
+		for (int e = 0; e < 2; e++)
+		{
+			glm::vec2 edge = rects[r][e + 1] - rects[r][e];
+			glm::vec2 axis(-edge.y, edge.x);
+			float minA = FLT_MAX, maxA = -FLT_MAX, minB = FLT_MAX, maxB = -FLT_MAX;
+			for (int i = 0; i < 4; i++)
+			{
+				float pa = glm::dot(axis, a[i]), pb = glm::dot(axis, b[i]);
+				minA = std::min(minA, pa);
+				maxA = std::max(maxA, pa);
+				minB = std::min(minB, pb);
+				maxB = std::max(maxB, pb);
+			}
+			float slack = EPSILON * glm::length(axis);
+			if (maxA <= minB + slack || maxB <= minA + slack)
+				return false;
+		}
+	}
+	return true;
+}
+
+// Writes the corners, in order, of a width by depth rectangle centred on center and turned by angle
+static void rect_corners(glm::vec2 center, float angle, float width, float depth, glm::vec2 corners[4])
+{
+	glm::vec2 x(cosf(angle), sinf(angle)), y(-x.y, x.x);
+	x *= 0.5f * width;
+	y *= 0.5f * depth;
+	corners[0] = center - x - y;
+	corners[1] = center + x - y;
+	corners[2] = center + x + y;
+	corners[3] = center - x + y;
+}
+
+// Constructor with defaults that suit a level of a few hundred stalls
+LayoutGenerator::LayoutGenerator()
+{
+	Iterations = 4000;
+	ChainsPerDirection = 4;
+	Seed = 1;
+	StartTemperature = 4.0f;
+	EndTemperature = 0.05f;
+	Step = 0.25f;
+	BestStalls = 0;
+	Candidates = 0;
+}
+
+// Depth across the aisle of one row of stalls at angle
+float LayoutGenerator::RowDepth(int angle) const
+{
+	float radians = glm::radians(GENERATOR_ANGLE_DEGREES[angle]);
+	return site.stallDepth * sinf(radians) + site.stallWidth * cosf(radians);
+}
+
+// Depth across the aisle of a whole module: two rows and the aisle between them
+float LayoutGenerator::ModulePitch(int angle) const
+{
+	return 2.0f * RowDepth(angle) + site.aisleWidths[angle];
+}
+
+// Returns true if a stall with these corners fits the site
+bool LayoutGenerator::StallFits(const glm::vec2 corners[4]) const
+{
+	// Inside the footprint: every corner inside and no outline edge cutting through
+	const std::vector<glm::vec2>& footprint = site.footprint;
+	for (int i = 0; i < 4; i++)
+	{
+		if (!point_in_polygon(footprint, corners[i]))
+			return false;
+	}
+	for (size_t i = 0, j = footprint.size() - 1; i < footprint.size(); j = i++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			if (segments_cross(footprint[j], footprint[i], corners[c], corners[(c + 1) % 4]))
+				return false;
+		}
+	}
+
+	// Only the columns of the grid cells the stall's bounds reach can touch it
+	glm::vec2 minimum = glm::min(glm::min(corners[0], corners[1]), glm::min(corners[2], corners[3]));
+	glm::vec2 maximum = glm::max(glm::max(corners[0], corners[1]), glm::max(corners[2], corners[3]));
+	if (site.columnSpacing.x > 0.0f && site.columnSpacing.y > 0.0f && site.columnSize > 0.0f)
+	{
+		float half = 0.5f * site.columnSize;
+		glm::vec2 first = glm::ceil((minimum - half - site.columnOrigin) / site.columnSpacing);
+		glm::vec2 last = glm::floor((maximum + half - site.columnOrigin) / site.columnSpacing);
+		for (float j = first.y; j <= last.y; j++)
+		{
+			for (float i = first.x; i <= last.x; i++)
+			{
+				glm::vec2 column[4];
+				rect_corners(site.columnOrigin + glm::vec2(i, j) * site.columnSpacing, 0.0f, site.columnSize, site.columnSize, column);
+				if (rects_overlap(corners, column))
+					return false;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < keepOuts.size(); i += 4)
+	{
+		if (rects_overlap(corners, &keepOuts[i]))
+			return false;
+	}
+	return true;
+}
+
+// Places the stalls of a module starting at start along v; appends them to stalls if it is not NULL
+int LayoutGenerator::PlaceModule(const Frame& frame, float start, Gene gene, std::vector<StallInstance>* stalls, LayoutSegment* aisle) const
+{
+	float radians = glm::radians(GENERATOR_ANGLE_DEGREES[gene.angle]);
+	float rowDepth = RowDepth(gene.angle);
+	float aisleWidth = site.aisleWidths[gene.angle];
+	// Stalls in a row touch side by side, each takes extent along the row
+	float spacing = site.stallWidth / sinf(radians);
+	float extent = site.stallWidth * sinf(radians) + site.stallDepth * cosf(radians);
+	float shift = fmodf(gene.shift * Step, spacing);
+	float direction = atan2f(frame.u.y, frame.u.x);
+	float tilt = glm::half_pi<float>() - radians;
+
+	// Corners come from the row geometry kernel, reused per worker so scoring does not allocate
+	static thread_local std::vector<GLfloat> vertices;
+	float firstAlong = frame.minU + shift + 0.5f * extent;
+	GLuint perRow = firstAlong + 0.5f * extent <= frame.maxU ? (GLuint)floorf((frame.maxU - 0.5f * extent - firstAlong) / spacing) + 1 : 0;
+	vertices.resize((size_t)perRow * STALL_ROW_FLOATS);
+
+	int count = 0;
+	float firstU = FLT_MAX, lastU = -FLT_MAX;
+	for (int row = 0; row < 2 && perRow > 0; row++)
+	{
+		// The rows face each other across the aisle, tilted the same way so both are entered driving one way
+		StallRow stallRow;
+		float across = start + (row == 0 ? 0.5f * rowDepth : 1.5f * rowDepth + aisleWidth);
+		stallRow.origin = frame.u * firstAlong + frame.v * across;
+		stallRow.direction = frame.u;
+		stallRow.width = site.stallWidth;
+		stallRow.depth = site.stallDepth;
+		stallRow.angle = row == 0 ? radians : glm::pi<float>() - radians;
+		stallRow.count = perRow;
+		stall_row_vertices(stallRow, vertices.data());
+		float angle = row == 0 ? direction - tilt : direction + tilt;
+		for (GLuint k = 0; k < perRow; k++)
+		{
+			// Kernel order is lower left, lower right, upper left, upper right; the tests want them around the edge
+			const GLfloat* quad = vertices.data() + (size_t)k * STALL_ROW_FLOATS;
+			glm::vec2 corners[4];
+			corners[0] = glm::vec2(quad[0], quad[1]);
+			corners[1] = glm::vec2(quad[STALL_VERTEX_FLOATS], quad[STALL_VERTEX_FLOATS + 1]);
+			corners[2] = glm::vec2(quad[3 * STALL_VERTEX_FLOATS], quad[3 * STALL_VERTEX_FLOATS + 1]);
+			corners[3] = glm::vec2(quad[2 * STALL_VERTEX_FLOATS], quad[2 * STALL_VERTEX_FLOATS + 1]);
+			if (!StallFits(corners))
+				continue;
+			count++;
+			float along = firstAlong + k * spacing;
+			firstU = std::min(firstU, along - 0.5f * extent);
+			lastU = std::max(lastU, along + 0.5f * extent);
+			if (stalls != NULL)
+			{
+				glm::vec2 center = 0.5f * (corners[0] + corners[2]);
+				StallInstance stall;
+				stall.x = center.x;
+				stall.y = center.y;
+				stall.angle = angle;
+				stall.width = site.stallWidth;
+				stall.depth = site.stallDepth;
+				stall.state = 0;
+				stall.sprite = NO_SPRITE;
+				stalls->push_back(stall);
+			}
+		}
+	}
+
+	// The aisle runs past every stall of the module
+	if (aisle != NULL && count > 0)
+	{
+		float across = start + rowDepth + 0.5f * aisleWidth;
+		aisle->from = frame.u * firstU + frame.v * across;
+		aisle->to = frame.u * lastU + frame.v * across;
+		aisle->width = aisleWidth;
+		aisle->toLevel = -1;
+	}
+	return count;
+}
+
+// Scores modules first onwards, reusing those that neither moved nor changed
+void LayoutGenerator::Rescore(Chain& chain, size_t first) const
+{
+	Candidate& current = chain.current;
+	const Frame& frame = frames[current.frame];
+	for (size_t k = first; k < current.genes.size(); k++)
+	{
+		float start = k == 0 ? frame.minV + current.offset * Step : chain.starts[k - 1] + ModulePitch(current.genes[k - 1].angle);
+		// Past the changed module, a module that did not move keeps its score and so do all after it
+		if (k > first && start == chain.starts[k])
+			break;
+		chain.starts[k] = start;
+
+		int score = 0;
+		if (start < frame.maxV)
+		{
+			uint32_t startBits;
+			memcpy(&startBits, &start, sizeof(startBits));
+			uint64_t key = ((uint64_t)startBits << 32) | ((uint64_t)current.genes[k].angle << 16) | current.genes[k].shift;
+			std::unordered_map<uint64_t, int>::iterator found = chain.memo.find(key);
+			if (found != chain.memo.end())
+				score = found->second;
+			else
+			{
+				score = PlaceModule(frame, start, current.genes[k], NULL, NULL);
+				chain.memo[key] = score;
+			}
+		}
+		current.stalls += score - chain.scores[k];
+		chain.scores[k] = score;
+	}
+	chain.candidates++;
+}
+
+// Runs one annealing chain from its seed
+void LayoutGenerator::RunChain(Chain& chain, uint32_t seed) const
+{
+	uint64_t state = seed;
+	Candidate& current = chain.current;
+	const Frame& frame = frames[current.frame];
+
+	// Enough modules to cover the footprint at the narrowest pitch
+	float minPitch = FLT_MAX, maxPitch = 0.0f, maxSpacing = 0.0f;
+	for (int a = 0; a < GENERATOR_ANGLES; a++)
+	{
+		minPitch = std::min(minPitch, ModulePitch(a));
+		maxPitch = std::max(maxPitch, ModulePitch(a));
+		maxSpacing = std::max(maxSpacing, site.stallWidth / sinf(glm::radians(GENERATOR_ANGLE_DEGREES[a])));
+	}
+	size_t modules = (size_t)ceilf((frame.maxV - frame.minV) / minPitch) + 1;
+	int offsets = std::max(1, (int)ceilf(maxPitch / Step));
+	int shifts = std::max(1, (int)ceilf(maxSpacing / Step));
+
+	current.offset = random_below(state, offsets);
+	current.genes.resize(modules);
+	for (size_t k = 0; k < modules; k++)
+	{
+		current.genes[k].angle = (uint8_t)random_below(state, GENERATOR_ANGLES);
+		current.genes[k].shift = (uint16_t)random_below(state, shifts);
+	}
+	current.stalls = 0;
+	chain.starts.assign(modules, NAN);
+	chain.scores.assign(modules, 0);
+	chain.candidates = 0;
+	Rescore(chain, 0);
+	chain.best = current;
+
+	Candidate saved;
+	std::vector<float> savedStarts;
+	std::vector<int> savedScores;
+	for (int it = 0; it < Iterations; it++)
+	{
+		float t = Iterations > 1 ? (float)it / (float)(Iterations - 1) : 1.0f;
+		float temperature = StartTemperature * powf(EndTemperature / StartTemperature, t);
+		saved = current;
+		savedStarts = chain.starts;
+		savedScores = chain.scores;
+
+		// Moving the first row shifts every module, the other moves change one
+		float move = random_unit(state);
+		size_t changed = 0;
+		if (move < 0.1f)
+			current.offset = random_below(state, offsets);
+		else
+		{
+			changed = (size_t)random_below(state, (int)modules);
+			if (move < 0.55f)
+				current.genes[changed].angle = (uint8_t)random_below(state, GENERATOR_ANGLES);
+			else
+				current.genes[changed].shift = (uint16_t)random_below(state, shifts);
+		}
+		Rescore(chain, changed);
+
+		int delta = current.stalls - saved.stalls;
+		if (delta < 0 && random_unit(state) >= expf((float)delta / temperature))
+		{
+			current = saved;
+			chain.starts = savedStarts;
+			chain.scores = savedScores;
+		}
+		else if (current.stalls > chain.best.stalls)
+			chain.best = current;
+	}
+}
+
+// Searches the site on the pool's workers, returns false if the footprint has no area
+bool LayoutGenerator::Generate(const GarageSite& site, ThreadPool& pool)
+{
+	this->site = site;
+	frames.clear();
+	keepOuts.clear();
+	BestStalls = 0;
+	Candidates = 0;
+	best = Candidate();
+	if (site.footprint.size() < 3)
+		return false;
+
+	// Ramps and entries become rectangles stalls may not overlap
+	for (size_t i = 0; i < site.ramps.size(); i++)
+	{
+		const LayoutSegment& ramp = site.ramps[i];
+		glm::vec2 along = ramp.to - ramp.from;
+		glm::vec2 corners[4];
+		rect_corners(0.5f * (ramp.from + ramp.to), atan2f(along.y, along.x), glm::length(along), ramp.width, corners);
+		keepOuts.insert(keepOuts.end(), corners, corners + 4);
+	}
+	for (size_t i = 0; i < site.entries.size(); i++)
+	{
+		glm::vec2 corners[4];
+		rect_corners(site.entries[i], 0.0f, 2.0f * site.entryClearance, 2.0f * site.entryClearance, corners);
+		keepOuts.insert(keepOuts.end(), corners, corners + 4);
+	}
+
+	// Aisles run along the axes and along and across every edge of the footprint
+	std::vector<float> directions;
+	directions.push_back(0.0f);
+	directions.push_back(glm::half_pi<float>());
+	for (size_t i = 0; i < site.footprint.size(); i++)
+	{
+		glm::vec2 edge = site.footprint[(i + 1) % site.footprint.size()] - site.footprint[i];
+		float angle = fmodf(atan2f(edge.y, edge.x) + glm::two_pi<float>(), glm::pi<float>());
+		directions.push_back(angle);
+		directions.push_back(fmodf(angle + glm::half_pi<float>(), glm::pi<float>()));
+	}
+	for (size_t i = 0; i < directions.size(); i++)
+	{
+		bool seen = false;
+		for (size_t f = 0; f < frames.size() && !seen; f++)
+		{
+			float difference = fabsf(atan2f(frames[f].u.y, frames[f].u.x) - directions[i]);
+			seen = std::min(difference, glm::pi<float>() - difference) < glm::radians(0.5f);
+		}
+		if (seen)
+			continue;
+		Frame frame;
+		frame.u = glm::vec2(cosf(directions[i]), sinf(directions[i]));
+		frame.v = glm::vec2(-frame.u.y, frame.u.x);
+		frame.minU = frame.minV = FLT_MAX;
+		frame.maxU = frame.maxV = -FLT_MAX;
+		for (size_t p = 0; p < site.footprint.size(); p++)
+		{
+			float u = glm::dot(frame.u, site.footprint[p]), v = glm::dot(frame.v, site.footprint[p]);
+			frame.minU = std::min(frame.minU, u);
+			frame.maxU = std::max(frame.maxU, u);
+			frame.minV = std::min(frame.minV, v);
+			frame.maxV = std::max(frame.maxV, v);
+		}
+		if (frame.maxU - frame.minU <= 0.0f || frame.maxV - frame.minV <= 0.0f)
+			return false;
+		frames.push_back(frame);
+	}
+
+	// Chains only share read-only state, each writes its own slot
+	std::vector<Chain> chains(frames.size() * std::max(1, ChainsPerDirection));
+	uint64_t seeds = Seed;
+	for (size_t i = 0; i < chains.size(); i++)
+	{
+		chains[i].current.frame = (int)(i % frames.size());
+		uint32_t seed = (uint32_t)next_random(seeds);
+		Chain* chain = &chains[i];
+		pool.Enqueue([this, chain, seed]() { RunChain(*chain, seed); });
+	}
+	pool.Wait();
+
+	// The first chain with the most stalls wins, whichever finished first
+	for (size_t i = 0; i < chains.size(); i++)
+	{
+		Candidates += chains[i].candidates;
+		if (i == 0 || chains[i].best.stalls > best.stalls)
+			best = chains[i].best;
+	}
+	BestStalls = best.stalls;
+	return true;
+}
+
+// Adds the best layout found as a new level of layout, with its aisles and the site's ramps
+int LayoutGenerator::Build(GarageLayout& layout, const std::string& levelName) const
+{
+	int level = layout.AddLevel(levelName);
+	if (frames.empty())
+		return level;
+	const Frame& frame = frames[best.frame];
+	std::vector<StallInstance> stalls;
+	float start = frame.minV + best.offset * Step;
+	for (size_t k = 0; k < best.genes.size() && start < frame.maxV; k++)
+	{
+		LayoutSegment aisle;
+		if (PlaceModule(frame, start, best.genes[k], &stalls, &aisle) > 0)
+			layout.AddAisle(level, aisle.from, aisle.to, aisle.width);
+		start += ModulePitch(best.genes[k].angle);
+	}
+	layout.Reserve(level, stalls.size());
+	for (size_t i = 0; i < stalls.size(); i++)
+		layout.AddStall(level, stalls[i]);
+	for (size_t i = 0; i < site.ramps.size(); i++)
+		layout.AddRamp(level, site.ramps[i].from, site.ramps[i].to, site.ramps[i].width, site.ramps[i].toLevel);
+	return level;
+}
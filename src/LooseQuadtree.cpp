@@ -0,0 +1,182 @@
+#include"Header_Files/LooseQuadtree.h"
+#include<algorithm>
+
+// Node marker for elements that are not in the tree
+static const int NO_NODE = -1;
+
+// Returns true if two (min x, min y, max x, max y) rectangles overlap
+static bool overlaps(const glm::vec4& a, const glm::vec4& b)
+{
+	return a.x <= b.z && b.x <= a.z && a.y <= b.w && b.y <= a.w;
+}
+
+// Constructor that covers the world from worldMin to worldMax with at most maxDepth levels below the root
+LooseQuadtree::LooseQuadtree(glm::vec2 worldMin, glm::vec2 worldMax, int maxDepth)
+{
+	this->worldMin = worldMin;
+	this->worldMax = worldMax;
+	this->maxDepth = maxDepth;
+	count = 0;
+	Clear();
+}
+
+// Removes every element
+void LooseQuadtree::Clear()
+{
+	nodes.clear();
+	items.clear();
+	count = 0;
+	// The root is a square around the whole world
+	Node root;
+	root.center = 0.5f * (worldMin + worldMax);
+	root.halfSize = 0.5f * std::max(worldMax.x - worldMin.x, worldMax.y - worldMin.y);
+	root.firstChild = -1;
+	root.parent = -1;
+	root.subtreeCount = 0;
+	nodes.push_back(root);
+}
+
+// Number of elements in the tree
+size_t LooseQuadtree::Size() const
+{
+	return count;
+}
+
+// Returns the node an element with bounds belongs in, creating nodes on the way
+int LooseQuadtree::Place(const glm::vec4& bounds)
+{
+	glm::vec2 center(0.5f * (bounds.x + bounds.z), 0.5f * (bounds.y + bounds.w));
+	float extent = std::max(bounds.z - bounds.x, bounds.w - bounds.y);
+
+	// Elements centred outside the world stay in the root, which every query visits
+	int node = 0;
+	if (center.x < worldMin.x || center.y < worldMin.y || center.x > worldMax.x || center.y > worldMax.y)
+		return node;
+
+	// Descend while the element still fits the next level's loose bounds: with the centre
+	// inside a cell, anything up to a cell wide stays within half a cell of its edges
+	for (int depth = 0; depth < maxDepth; depth++)
+	{
+		float childHalf = 0.5f * nodes[node].halfSize;
+		if (extent > 2.0f * childHalf)
+			break;
+		if (nodes[node].firstChild < 0)
+		{
+			int first = (int)nodes.size();
+			for (int i = 0; i < 4; i++)
+			{
+				Node child;
+				child.center = nodes[node].center + glm::vec2(i & 1 ? childHalf : -childHalf, i & 2 ? childHalf : -childHalf);
+				child.halfSize = childHalf;
+				child.firstChild = -1;
+				child.parent = node;
+				child.subtreeCount = 0;
+				nodes.push_back(child);
+			}
+			nodes[node].firstChild = first;
+		}
+		int quadrant = (center.x >= nodes[node].center.x ? 1 : 0) + (center.y >= nodes[node].center.y ? 2 : 0);
+		node = nodes[node].firstChild + quadrant;
+	}
+	return node;
+}
+
+// Adds id to node and to the counts of its ancestors
+void LooseQuadtree::Link(GLuint id, int node)
+{
+	items[id].node = node;
+	items[id].slot = (GLuint)nodes[node].items.size();
+	nodes[node].items.push_back(id);
+	for (int n = node; n >= 0; n = nodes[n].parent)
+		nodes[n].subtreeCount++;
+	count++;
+}
+
+// Takes id out of its node and the counts of its ancestors
+void LooseQuadtree::Unlink(GLuint id)
+{
+	int node = items[id].node;
+	std::vector<GLuint>& list = nodes[node].items;
+	// Swap the last element into the hole so removal is constant time
+	GLuint moved = list.back();
+	list[items[id].slot] = moved;
+	items[moved].slot = items[id].slot;
+	list.pop_back();
+	for (int n = node; n >= 0; n = nodes[n].parent)
+		nodes[n].subtreeCount--;
+	items[id].node = NO_NODE;
+	count--;
+}
+
+// Adds element id (any index below a few million) with the given bounds
+void LooseQuadtree::Insert(GLuint id, const glm::vec4& bounds)
+{
+	if (id >= items.size())
+	{
+		Item empty;
+		empty.bounds = glm::vec4(0.0f);
+		empty.node = NO_NODE;
+		empty.slot = 0;
+		items.resize(id + 1, empty);
+	}
+	if (items[id].node != NO_NODE)
+		Unlink(id);
+	items[id].bounds = bounds;
+	Link(id, Place(bounds));
+}
+
+// Moves element id to new bounds, inserting it if it is not in the tree yet
+void LooseQuadtree::Update(GLuint id, const glm::vec4& bounds)
+{
+	if (id >= items.size() || items[id].node == NO_NODE)
+	{
+		Insert(id, bounds);
+		return;
+	}
+	int node = Place(bounds);
+	items[id].bounds = bounds;
+	// Most moves stay inside the same node and only change the stored bounds
+	if (node != items[id].node)
+	{
+		Unlink(id);
+		Link(id, node);
+	}
+}
+
+// Removes element id
+void LooseQuadtree::Remove(GLuint id)
+{
+	if (id < items.size() && items[id].node != NO_NODE)
+		Unlink(id);
+}
+
+// Appends the overlapping elements of a subtree
+void LooseQuadtree::QueryNode(int node, const glm::vec4& rect, std::vector<GLuint>& ids) const
+{
+	const Node& current = nodes[node];
+	if (current.subtreeCount == 0)
+		return;
+	// The root also holds elements outside the world, so it is always searched
+	float loose = 2.0f * current.halfSize;
+	glm::vec4 looseBounds(current.center - loose, current.center + loose);
+	if (node != 0 && !overlaps(looseBounds, rect))
+		return;
+
+	for (size_t i = 0; i < current.items.size(); i++)
+	{
+		GLuint id = current.items[i];
+		if (overlaps(items[id].bounds, rect))
+			ids.push_back(id);
+	}
+	if (current.firstChild >= 0)
+	{
+		for (int i = 0; i < 4; i++)
+			QueryNode(current.firstChild + i, rect, ids);
+	}
+}
+
+// Appends the id of every element whose bounds overlap rect
+void LooseQuadtree::Query(const glm::vec4& rect, std::vector<GLuint>& ids) const
+{
+	QueryNode(0, rect, ids);
+}
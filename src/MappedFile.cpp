@@ -0,0 +1,96 @@
+#include"Header_Files/MappedFile.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Constructor that creates an empty handle
+MappedFile::MappedFile()
+{
+	Data = NULL;
+	Size = 0;
+#ifdef _WIN32
+	fileHandle = NULL;
+	mappingHandle = NULL;
+#endif
+}
+
+// Maps path into memory, returns false if it cannot be opened or is empty
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle = file;
+	mappingHandle = mapping;
+	Data = (const unsigned char*)view;
+	Size = (size_t)size.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the descriptor is closed
+	close(fd);
+	if (view == MAP_FAILED)
+		return false;
+	Data = (const unsigned char*)view;
+	Size = (size_t)info.st_size;
+#endif
+	return true;
+}
+
+// Returns true while a file is mapped
+bool MappedFile::IsOpen() const
+{
+	return Data != NULL;
+}
+
+// Unmaps the file
+void MappedFile::Close()
+{
+	if (Data == NULL)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(Data);
+	CloseHandle((HANDLE)mappingHandle);
+	CloseHandle((HANDLE)fileHandle);
+	fileHandle = NULL;
+	mappingHandle = NULL;
+#else
+	munmap((void*)Data, Size);
+#endif
+	Data = NULL;
+	Size = 0;
+}
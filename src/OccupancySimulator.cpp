@@ -0,0 +1,216 @@
+#include"Header_Files/OccupancySimulator.h"
+#include<cmath>
+
+// Stall states the simulator sets, as drawn by the stall shader
+static const GLuint FREE = 0;
+static const GLuint OCCUPIED = 1;
+static const GLuint RESERVED = 2;
+static const GLuint ACCESSIBLE = 3;
+
+// Next value of a splitmix64 sequence, so every platform simulates the same run for a seed
+static uint64_t next_random(uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// Uniform double in (0, 1]
+static double random_unit(uint64_t& state)
+{
+	return (double)((next_random(state) >> 11) + 1) / 9007199254740992.0;
+}
+
+// Constructor with a weekday profile for a city-centre garage of about 500 stalls
+OccupancySimulator::OccupancySimulator()
+{
+	// Commuters arrive in the morning, shoppers through the day and a few visitors in the evening
+	static const float profile[24] = {
+		2.0f, 1.0f, 1.0f, 1.0f, 2.0f, 8.0f, 30.0f, 80.0f, 120.0f, 90.0f, 60.0f, 55.0f,
+		70.0f, 60.0f, 50.0f, 55.0f, 60.0f, 70.0f, 50.0f, 35.0f, 25.0f, 15.0f, 8.0f, 4.0f
+	};
+	for (int h = 0; h < 24; h++)
+		HourlyArrivals[h] = profile[h];
+	WeekendFactor = 0.6f;
+	DwellMinutes = 180.0f;
+	DwellSpread = 0.8f;
+	AccessibleShare = 0.04f;
+	Seed = 1;
+	Arrivals = Parked = TurnedAway = 0;
+	PeakOccupied = 0;
+	OccupiedMinutes = 0.0;
+	for (int h = 0; h < 24; h++)
+	{
+		HourOccupancy[h] = 0.0;
+		HourSamples[h] = 0;
+	}
+	random = Seed;
+	now = 0.0;
+	occupied = 0;
+}
+
+// Takes the stalls of every level of layout, all free, and starts at minute 0
+void OccupancySimulator::Reset(const GarageLayout& layout)
+{
+	stalls.clear();
+	freeStandard.clear();
+	freeAccessible.clear();
+	for (size_t l = 0; l < layout.Levels.size(); l++)
+	{
+		const GarageLevel& level = layout.Levels[l];
+		for (size_t s = 0; s < level.StallCount(); s++)
+		{
+			if (level.states[s] == RESERVED)
+				continue;
+			Stall stall;
+			stall.level = (int)l;
+			stall.stall = (GLuint)s;
+			stall.freeState = level.states[s] == ACCESSIBLE || level.types[s] == STALL_ACCESSIBLE ? ACCESSIBLE : FREE;
+			stalls.push_back(stall);
+			if (level.states[s] != stall.freeState && OnStateChange)
+				OnStateChange(stall.level, stall.stall, stall.freeState);
+		}
+	}
+	// Stacks pop from the back, so the first stalls of the layout fill first
+	for (size_t i = stalls.size(); i-- > 0;)
+		(stalls[i].freeState == ACCESSIBLE ? freeAccessible : freeStandard).push_back((GLuint)i);
+
+	Arrivals = Parked = TurnedAway = 0;
+	PeakOccupied = 0;
+	OccupiedMinutes = 0.0;
+	for (int h = 0; h < 24; h++)
+	{
+		HourOccupancy[h] = 0.0;
+		HourSamples[h] = 0;
+	}
+	random = Seed;
+	now = 0.0;
+	occupied = 0;
+
+	// Every stall holds at most one pending departure, besides them wait the next arrival and sample
+	queue.Clear();
+	queue.Reserve(stalls.size() + 2);
+	double arrival = NextArrival(0.0);
+	if (arrival >= 0.0)
+		queue.Push(arrival, EVENT_ARRIVAL, 0);
+	queue.Push(0.0, EVENT_SAMPLE, 0);
+}
+
+// Runs every event up to and including minute
+void OccupancySimulator::RunUntil(double minute)
+{
+	SimEvent event;
+	while (queue.Size() > 0 && queue.PeekTime() <= minute)
+	{
+		queue.Pop(event);
+		OccupiedMinutes += occupied * (event.time - now);
+		now = event.time;
+		Dispatch(event);
+	}
+	if (minute > now)
+	{
+		OccupiedMinutes += occupied * (minute - now);
+		now = minute;
+	}
+}
+
+// Current minute of the simulation
+double OccupancySimulator::Now() const
+{
+	return now;
+}
+
+// Number of stalls occupied now
+GLuint OccupancySimulator::Occupied() const
+{
+	return occupied;
+}
+
+// Number of stalls vehicles can be assigned
+GLuint OccupancySimulator::Capacity() const
+{
+	return (GLuint)stalls.size();
+}
+
+// Average share of the assignable stalls occupied so far
+double OccupancySimulator::AverageOccupancy() const
+{
+	return now > 0.0 && !stalls.empty() ? OccupiedMinutes / (now * stalls.size()) : 0.0;
+}
+
+// Returns the time of the next arrival after time, following the hourly rates; negative if none come
+double OccupancySimulator::NextArrival(double time)
+{
+	// The process is memoryless, so an hour without an arrival just starts over from the next hour
+	for (int quietHours = 0; quietHours <= 7 * 24;)
+	{
+		double hour = floor(time / 60.0);
+		int day = (int)fmod(floor(time / 1440.0), 7.0);
+		double perMinute = HourlyArrivals[(int)fmod(hour, 24.0)] * (day >= 5 ? WeekendFactor : 1.0f) / 60.0;
+		double hourEnd = (hour + 1.0) * 60.0;
+		if (perMinute > 0.0)
+		{
+			double arrival = time - log(random_unit(random)) / perMinute;
+			if (arrival < hourEnd)
+				return arrival;
+			quietHours = 0;
+		}
+		else
+			quietHours++;
+		time = hourEnd;
+	}
+	return -1.0;
+}
+
+// Handles one event
+void OccupancySimulator::Dispatch(const SimEvent& event)
+{
+	if (event.kind == EVENT_ARRIVAL)
+	{
+		Arrivals++;
+		// Permit holders take an accessible stall if one is free, anyone else a standard one
+		bool permit = random_unit(random) <= AccessibleShare;
+		std::vector<GLuint>* free = permit && !freeAccessible.empty() ? &freeAccessible : &freeStandard;
+		if (free->empty())
+			TurnedAway++;
+		else
+		{
+			GLuint stall = free->back();
+			free->pop_back();
+			ReportState(stall, OCCUPIED);
+			occupied++;
+			Parked++;
+			if (occupied > PeakOccupied)
+				PeakOccupied = occupied;
+			// Log-normal dwell with the configured mean: exp(mu + sigma * z) with mu = ln(mean) - sigma^2 / 2
+			double z = sqrt(-2.0 * log(random_unit(random))) * cos(6.283185307179586 * random_unit(random));
+			double mu = log((double)DwellMinutes) - 0.5 * DwellSpread * DwellSpread;
+			queue.Push(now + exp(mu + DwellSpread * z), EVENT_DEPARTURE, stall);
+		}
+		double arrival = NextArrival(now);
+		if (arrival >= 0.0)
+			queue.Push(arrival, EVENT_ARRIVAL, 0);
+	}
+	else if (event.kind == EVENT_DEPARTURE)
+	{
+		GLuint stall = event.subject;
+		ReportState(stall, stalls[stall].freeState);
+		(stalls[stall].freeState == ACCESSIBLE ? freeAccessible : freeStandard).push_back(stall);
+		occupied--;
+	}
+	else if (event.kind == EVENT_SAMPLE)
+	{
+		int hour = (int)fmod(floor(now / 60.0), 24.0);
+		HourOccupancy[hour] += stalls.empty() ? 0.0 : (double)occupied / stalls.size();
+		HourSamples[hour]++;
+		queue.Push(now + 60.0, EVENT_SAMPLE, 0);
+	}
+}
+
+// Reports a new state for a stall
+void OccupancySimulator::ReportState(GLuint stall, GLuint state)
+{
+	if (OnStateChange)
+		OnStateChange(stalls[stall].level, stalls[stall].stall, state);
+}
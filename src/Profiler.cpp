@@ -0,0 +1,255 @@
+#include"Header_Files/Profiler.h"
+#include<algorithm>
+#include<cfloat>
+#include<cstdio>
+#include<fstream>
+#include<iomanip>
+#include<iostream>
+
+// Constructor that calibrates the GPU clock against the CPU clock (needs a current context)
+Profiler::Profiler()
+{
+	// Both clocks are sampled back to back, later GPU timestamps are placed relative to this
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	origin = std::chrono::steady_clock::now();
+	gpuOrigin = (int64_t)gpuNow;
+}
+
+// Nanoseconds since origin on the CPU clock
+int64_t Profiler::Now() const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+// Returns a query object from the free list or a new one
+GLuint Profiler::AcquireQuery()
+{
+	GLuint query;
+	if (freeQueries.empty())
+		glGenQueries(1, &query);
+	else
+	{
+		query = freeQueries.back();
+		freeQueries.pop_back();
+	}
+	return query;
+}
+
+// Adds a finished zone to the statistics and the trace, mutex must be held
+void Profiler::Record(const char* name, bool gpu, unsigned int thread, int64_t start, int64_t duration)
+{
+	Event event;
+	event.name = name;
+	event.gpu = gpu;
+	event.thread = thread;
+	event.start = start;
+	event.duration = duration;
+	if (events.size() >= MAX_TRACE_EVENTS)
+		events.pop_front();
+	events.push_back(event);
+
+	std::string key = std::string(gpu ? "gpu:" : "cpu:") + name;
+	double milliseconds = duration / 1e6;
+	std::unordered_map<std::string, ZoneStats>::iterator found = stats.find(key);
+	if (found == stats.end())
+	{
+		ZoneStats zone;
+		zone.Count = 1;
+		zone.Total = zone.Min = zone.Max = zone.Last = milliseconds;
+		stats[key] = zone;
+		return;
+	}
+	ZoneStats& zone = found->second;
+	zone.Count++;
+	zone.Total += milliseconds;
+	zone.Min = std::min(zone.Min, milliseconds);
+	zone.Max = std::max(zone.Max, milliseconds);
+	zone.Last = milliseconds;
+}
+
+// Reads back the oldest pending frame, waiting for it only if wait is set; returns false if it is not ready
+bool Profiler::Resolve(bool wait)
+{
+	if (pendingFrames.empty())
+		return false;
+	std::vector<GPUZone>& frame = pendingFrames.front();
+	if (!wait && !frame.empty())
+	{
+		// Queries complete in order, so the frame is done once its last query is
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(frame.back().end, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available != GL_TRUE)
+			return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < frame.size(); i++)
+	{
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(frame[i].begin, GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(frame[i].end, GL_QUERY_RESULT, &end);
+		Record(frame[i].name, true, 0, (int64_t)begin - gpuOrigin, (int64_t)(end - begin));
+		freeQueries.push_back(frame[i].begin);
+		freeQueries.push_back(frame[i].end);
+	}
+	pendingFrames.pop_front();
+	return true;
+}
+
+// Reads back finished GPU zones, call at the start of every frame on the GL thread
+void Profiler::BeginFrame()
+{
+	while (Resolve(false))
+	{
+	}
+	// Only wait when the GPU is more than FRAME_LATENCY frames behind
+	while (pendingFrames.size() >= FRAME_LATENCY)
+		Resolve(true);
+}
+
+// Closes the frame's GPU zones, call at the end of every frame on the GL thread
+void Profiler::EndFrame()
+{
+	while (!openGPU.empty())
+		EndGPU();
+	if (!currentFrame.empty())
+		pendingFrames.push_back(currentFrame);
+	currentFrame.clear();
+}
+
+// Starts a CPU zone on the calling thread, name must outlive the profiler
+void Profiler::BeginCPU(const char* name)
+{
+	OpenZone zone;
+	zone.name = name;
+	zone.start = Now();
+	std::lock_guard<std::mutex> lock(mutex);
+	openCPU[std::this_thread::get_id()].push_back(zone);
+}
+
+// Ends the calling thread's innermost CPU zone
+void Profiler::EndCPU()
+{
+	int64_t end = Now();
+	std::thread::id id = std::this_thread::get_id();
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<OpenZone>& open = openCPU[id];
+	if (open.empty())
+		return;
+	OpenZone zone = open.back();
+	open.pop_back();
+	// GPU events use thread 0, CPU threads are numbered in the order they first report
+	std::unordered_map<std::thread::id, unsigned int>::iterator number = threadNumbers.find(id);
+	if (number == threadNumbers.end())
+		number = threadNumbers.insert(std::make_pair(id, (unsigned int)threadNumbers.size() + 1)).first;
+	Record(zone.name, false, number->second, zone.start, end - zone.start);
+}
+
+// Starts a GPU zone around the commands issued until EndGPU, on the GL thread
+void Profiler::BeginGPU(const char* name)
+{
+	// Timestamps rather than GL_TIME_ELAPSED, so GPU zones can nest
+	GPUZone zone;
+	zone.name = name;
+	zone.begin = AcquireQuery();
+	zone.end = 0;
+	glQueryCounter(zone.begin, GL_TIMESTAMP);
+	openGPU.push_back(currentFrame.size());
+	currentFrame.push_back(zone);
+}
+
+// Ends the innermost GPU zone
+void Profiler::EndGPU()
+{
+	if (openGPU.empty())
+		return;
+	GPUZone& zone = currentFrame[openGPU.back()];
+	openGPU.pop_back();
+	zone.end = AcquireQuery();
+	glQueryCounter(zone.end, GL_TIMESTAMP);
+	// Keep the zone whose end was issued last at the back, Resolve checks that one
+	std::swap(zone, currentFrame.back());
+}
+
+// Returns the statistics of every zone name, CPU zones as "cpu:name" and GPU zones as "gpu:name"
+std::unordered_map<std::string, Profiler::ZoneStats> Profiler::Stats() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+// Prints the statistics as a table
+void Profiler::Report(std::ostream& out) const
+{
+	std::unordered_map<std::string, ZoneStats> current = Stats();
+	std::vector<std::string> names;
+	for (std::unordered_map<std::string, ZoneStats>::const_iterator it = current.begin(); it != current.end(); ++it)
+		names.push_back(it->first);
+	std::sort(names.begin(), names.end());
+
+	out << std::left << std::setw(28) << "zone" << std::right << std::setw(8) << "count"
+		<< std::setw(10) << "avg ms" << std::setw(10) << "min ms" << std::setw(10) << "max ms" << std::setw(10) << "last ms" << std::endl;
+	out << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		const ZoneStats& zone = current[names[i]];
+		out << std::left << std::setw(28) << names[i] << std::right << std::setw(8) << zone.Count
+			<< std::setw(10) << zone.Total / zone.Count << std::setw(10) << zone.Min
+			<< std::setw(10) << zone.Max << std::setw(10) << zone.Last << std::endl;
+	}
+	out << std::defaultfloat;
+}
+
+// Saves the recorded events as Chrome trace_event JSON, returns false if the file cannot be written
+bool Profiler::WriteTrace(const std::string& path) const
+{
+	std::ofstream out(path.c_str());
+	if (!out)
+	{
+		std::cerr << "ERROR: Failed to write trace: " << path << std::endl;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	out << "{\"traceEvents\":[\n";
+	out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+	for (std::unordered_map<std::thread::id, unsigned int>::const_iterator it = threadNumbers.begin(); it != threadNumbers.end(); ++it)
+		out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it->second << ",\"args\":{\"name\":\"CPU " << it->second << "\"}}";
+	// Complete events with timestamps and durations in microseconds
+	char line[256];
+	for (size_t i = 0; i < events.size(); i++)
+	{
+		const Event& event = events[i];
+		snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+			event.name, event.gpu ? "gpu" : "cpu", event.thread, event.start / 1e3, event.duration / 1e3);
+		out << line;
+	}
+	out << "\n]}\n";
+	return (bool)out;
+}
+
+// Deletes the query objects
+void Profiler::Delete()
+{
+	for (size_t i = 0; i < pendingFrames.size(); i++)
+	{
+		for (size_t j = 0; j < pendingFrames[i].size(); j++)
+		{
+			freeQueries.push_back(pendingFrames[i][j].begin);
+			freeQueries.push_back(pendingFrames[i][j].end);
+		}
+	}
+	for (size_t i = 0; i < currentFrame.size(); i++)
+	{
+		freeQueries.push_back(currentFrame[i].begin);
+		if (currentFrame[i].end != 0)
+			freeQueries.push_back(currentFrame[i].end);
+	}
+	pendingFrames.clear();
+	currentFrame.clear();
+	openGPU.clear();
+	if (!freeQueries.empty())
+		glDeleteQueries((GLsizei)freeQueries.size(), freeQueries.data());
+	freeQueries.clear();
+}
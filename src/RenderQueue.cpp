@@ -0,0 +1,141 @@
+#include"Header_Files/RenderQueue.h"
+
+// Constructor that creates an empty queue
+RenderQueue::RenderQueue()
+{
+	Executed = 0;
+	DrawCalls = 0;
+}
+
+// Builds a sort key: layer first, then program, texture and VAO, then a free order byte
+uint64_t RenderQueue::MakeKey(uint8_t layer, GLuint program, GLuint texture, GLuint vao, uint8_t order)
+{
+	return ((uint64_t)layer << 56)
+		| ((uint64_t)(program & 0xFFFF) << 40)
+		| ((uint64_t)(texture & 0xFFFF) << 24)
+		| ((uint64_t)(vao & 0xFFFF) << 8)
+		| (uint64_t)order;
+}
+
+// Builds a command drawing count indices of the VAO's element buffer
+RenderCommand RenderQueue::Indexed(uint8_t layer, GLuint program, GLuint texture, GLuint vao, GLsizei count, GLintptr offset, GLsizei instanceCount)
+{
+	RenderCommand command;
+	command.Key = MakeKey(layer, program, texture, vao);
+	command.Program = program;
+	command.VAO = vao;
+	command.Texture = texture;
+	command.Mode = GL_TRIANGLES;
+	command.Count = count;
+	command.Offset = offset;
+	command.InstanceCount = instanceCount;
+	return command;
+}
+
+// Adds one command, safe to call from any thread
+void RenderQueue::Push(const RenderCommand& command)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	pending.push_back(command);
+}
+
+// Adds a batch of commands recorded locally, taking the lock only once
+void RenderQueue::Submit(const std::vector<RenderCommand>& commands)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	pending.insert(pending.end(), commands.begin(), commands.end());
+}
+
+// Stable LSD radix sort of commands by key into sorted
+void RenderQueue::Sort()
+{
+	size_t n = commands.size();
+	keys.resize(n);
+	keysScratch.resize(n);
+	order.resize(n);
+	orderScratch.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		keys[i] = commands[i].Key;
+		order[i] = (uint32_t)i;
+	}
+
+	// One pass per key byte; bytes that are the same in every key are skipped
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		size_t counts[256] = { 0 };
+		for (size_t i = 0; i < n; i++)
+			counts[(keys[i] >> shift) & 0xFF]++;
+		if (counts[(keys[0] >> shift) & 0xFF] == n)
+			continue;
+
+		size_t offsets[256];
+		size_t total = 0;
+		for (int b = 0; b < 256; b++)
+		{
+			offsets[b] = total;
+			total += counts[b];
+		}
+		for (size_t i = 0; i < n; i++)
+		{
+			size_t dst = offsets[(keys[i] >> shift) & 0xFF]++;
+			keysScratch[dst] = keys[i];
+			orderScratch[dst] = order[i];
+		}
+		keys.swap(keysScratch);
+		order.swap(orderScratch);
+	}
+
+	sorted.resize(n);
+	for (size_t i = 0; i < n; i++)
+		sorted[i] = commands[order[i]];
+}
+
+// Sorts and replays every pushed command, must be called on the GL thread
+void RenderQueue::Execute(GLStateCache& state)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		commands.swap(pending);
+		pending.clear();
+	}
+	Executed = commands.size();
+	DrawCalls = 0;
+	if (commands.empty())
+		return;
+	Sort();
+
+	size_t i = 0;
+	while (i < sorted.size())
+	{
+		RenderCommand draw = sorted[i++];
+		// An empty instance buffer draws nothing, even if it still holds stale records
+		if (draw.InstanceCount == 0 || draw.Count == 0)
+			continue;
+		// Merge following plain draws with the same state whose index ranges continue this one
+		if (draw.InstanceCount == NOT_INSTANCED)
+		{
+			while (i < sorted.size())
+			{
+				const RenderCommand& next = sorted[i];
+				if (next.InstanceCount != NOT_INSTANCED || next.Program != draw.Program || next.VAO != draw.VAO
+					|| next.Texture != draw.Texture || next.Mode != draw.Mode
+					|| next.Offset != draw.Offset + (GLintptr)(draw.Count * sizeof(GLuint)))
+					break;
+				draw.Count += next.Count;
+				i++;
+			}
+		}
+
+		state.UseProgram(draw.Program);
+		if (draw.Texture != 0)
+			state.BindTextureUnit(0, GL_TEXTURE_2D, draw.Texture);
+		state.BindVertexArray(draw.VAO);
+		if (draw.InstanceCount != NOT_INSTANCED)
+			glDrawElementsInstanced(draw.Mode, draw.Count, GL_UNSIGNED_INT, (void*)draw.Offset, draw.InstanceCount);
+		else
+			glDrawElements(draw.Mode, draw.Count, GL_UNSIGNED_INT, (void*)draw.Offset);
+		DrawCalls++;
+	}
+	commands.clear();
+}
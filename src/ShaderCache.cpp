@@ -0,0 +1,161 @@
+#include"Header_Files/ShaderCache.h"
+#include<sys/stat.h>
+#include<cstdio>
+#include<cstring>
+#include<fstream>
+#include<iostream>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+// Identifies cache files and their layout version
+static const char BINARY_MAGIC[8] = { 'P', 'A', 'L', 'P', 'R', 'G', 0, 1 };
+
+// Fixed-size start of every cache file, followed by the program binary
+struct ShaderCacheHeader
+{
+	char magic[8];
+	uint32_t format;
+	uint32_t length;
+};
+
+// 64-bit FNV-1a hash, continuing from hash
+static uint64_t fnv1a(const void* data, size_t length, uint64_t hash)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Returns a GL string, or an empty one if the driver reports none
+static std::string gl_string(GLenum name)
+{
+	const GLubyte* value = glGetString(name);
+	return value != NULL ? std::string((const char*)value) : std::string();
+}
+
+// Constructor that uses directory for the cache, creating it if needed (needs a current context)
+ShaderCache::ShaderCache(const std::string& directory)
+{
+	Directory = directory;
+	GLint formats = 0;
+	if (GLAD_GL_ARB_get_program_binary)
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	Supported = formats > 0;
+	driver = gl_string(GL_VENDOR) + "\n" + gl_string(GL_RENDERER) + "\n" + gl_string(GL_VERSION);
+	if (Supported)
+	{
+#ifdef _WIN32
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+	}
+}
+
+// Hashes every source and define string together with the driver identity
+uint64_t ShaderCache::Key(const std::vector<std::string>& parts) const
+{
+	uint64_t hash = fnv1a(driver.data(), driver.size(), 14695981039346656037ull);
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		// Hash the length too so {"ab", "c"} and {"a", "bc"} differ
+		uint64_t length = parts[i].size();
+		hash = fnv1a(&length, sizeof(length), hash);
+		hash = fnv1a(parts[i].data(), parts[i].size(), hash);
+	}
+	return hash;
+}
+
+// Returns the cache file for a key
+std::string ShaderCache::EntryPath(uint64_t key) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)key);
+	return Directory + name;
+}
+
+// Creates a program from the cached binary for key, returns 0 if it is missing or rejected
+GLuint ShaderCache::Load(uint64_t key) const
+{
+	if (!Supported)
+		return 0;
+	std::string path = EntryPath(key);
+	std::ifstream in(path.c_str(), std::ios::binary);
+	if (!in)
+		return 0;
+
+	ShaderCacheHeader header;
+	if (!in.read((char*)&header, sizeof(header)) || memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+		return 0;
+	std::vector<char> binary(header.length);
+	if (header.length == 0 || !in.read(binary.data(), binary.size()))
+		return 0;
+	in.close();
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, (GLenum)header.format, binary.data(), (GLsizei)binary.size());
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (linked != GL_TRUE)
+	{
+		// The driver may reject binaries at any time, the caller compiles from source instead
+		glDeleteProgram(program);
+		remove(path.c_str());
+		return 0;
+	}
+	return program;
+}
+
+// Saves the binary of a successfully linked program under key
+bool ShaderCache::Store(uint64_t key, GLuint program) const
+{
+	if (!Supported)
+		return false;
+	GLint linked = GL_FALSE;
+	GLint length = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (linked != GL_TRUE || length <= 0)
+		return false;
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(program, length, &written, &format, binary.data());
+	if (written <= 0)
+		return false;
+
+	ShaderCacheHeader header;
+	memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	header.format = (uint32_t)format;
+	header.length = (uint32_t)written;
+
+	// Write to a temporary name first so a crash never leaves a truncated entry behind
+	std::string path = EntryPath(key);
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream out(temporary.c_str(), std::ios::binary);
+		if (!out)
+			return false;
+		out.write((const char*)&header, sizeof(header));
+		out.write(binary.data(), written);
+		if (!out)
+		{
+			out.close();
+			remove(temporary.c_str());
+			return false;
+		}
+	}
+	remove(path.c_str());
+	if (rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,310 @@
+#include"Header_Files/ShaderLibrary.h"
+#include<iostream>
+
+// Deepest chain of nested #includes before a file is assumed to include itself
+static const int MAX_INCLUDE_DEPTH = 16;
+
+// Constructor that creates an empty library, cache may be NULL
+ShaderLibrary::ShaderLibrary(ShaderCache* cache)
+{
+	ShaderLibrary::cache = cache;
+}
+
+// Compact lookup key of a permutation
+uint64_t ShaderLibrary::PermutationKey(GLuint program, GLuint mask)
+{
+	return ((uint64_t)program << 32) | mask;
+}
+
+// Registers a program and its optional defines, bit i of a mask enables defines[i]; returns the program index
+GLuint ShaderLibrary::Add(const char* vertexFile, const char* fragmentFile, const std::vector<std::string>& defines)
+{
+	ProgramSource source;
+	source.vertexFile = vertexFile;
+	source.fragmentFile = fragmentFile;
+	source.defines = defines;
+	programs.push_back(source);
+	return (GLuint)programs.size() - 1;
+}
+
+// Queues a permutation to be built by the next Build
+void ShaderLibrary::Request(GLuint program, GLuint mask)
+{
+	if (program >= programs.size())
+	{
+		std::cerr << "ERROR: Unknown shader program index " << program << std::endl;
+		return;
+	}
+	requested.push_back(PermutationKey(program, mask));
+}
+
+// Returns a file with its #includes resolved, reading each file only once
+const std::string& ShaderLibrary::Resolve(const std::string& file, int depth)
+{
+	std::unordered_map<std::string, std::string>::iterator found = resolved.find(file);
+	if (found != resolved.end())
+		return found->second;
+
+	std::string source = get_file_contents(file.c_str());
+	includes[file].clear();
+	std::string output;
+	output.reserve(source.size());
+	size_t lineStart = 0;
+	int lineNumber = 1;
+	while (lineStart < source.size())
+	{
+		size_t lineEnd = source.find('\n', lineStart);
+		if (lineEnd == std::string::npos)
+			lineEnd = source.size();
+		std::string line = source.substr(lineStart, lineEnd - lineStart);
+
+		size_t first = line.find_first_not_of(" \t");
+		size_t open = line.find('"');
+		size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+		if (first != std::string::npos && line.compare(first, 8, "#include") == 0 && close != std::string::npos)
+		{
+			if (depth >= MAX_INCLUDE_DEPTH)
+			{
+				std::cerr << "ERROR: Shader includes nest too deep in " << file << std::endl;
+				break;
+			}
+			std::string included = line.substr(open + 1, close - open - 1);
+			includes[file].push_back(included);
+			output += "#line 1\n";
+			output += Resolve(included, depth + 1);
+			// Keep compiler messages pointing at the right line of this file
+			output += "\n#line " + std::to_string(lineNumber + 1) + "\n";
+		}
+		else
+		{
+			output += line;
+			output += '\n';
+		}
+		lineStart = lineEnd + 1;
+		lineNumber++;
+	}
+	return resolved[file] = output;
+}
+
+// Inserts a #define for every bit of mask right after the #version line
+std::string ShaderLibrary::InjectDefines(const std::string& source, const std::vector<std::string>& defines, GLuint mask)
+{
+	std::string block;
+	for (size_t i = 0; i < defines.size() && i < 32; i++)
+	{
+		if (mask & (1u << i))
+			block += "#define " + defines[i] + " 1\n";
+	}
+	if (block.empty())
+		return source;
+
+	// #version has to stay the first statement, the defines go on the lines after it
+	size_t version = source.find("#version");
+	size_t insertAt = version == std::string::npos ? 0 : source.find('\n', version);
+	if (insertAt == std::string::npos)
+		insertAt = source.size();
+	else if (version != std::string::npos)
+		insertAt++;
+	block += "#line " + std::to_string(version == std::string::npos ? 1 : 2) + "\n";
+	return source.substr(0, insertAt) + block + source.substr(insertAt);
+}
+
+// Prints the info log of a shader that failed to compile
+void ShaderLibrary::ReportCompile(GLuint shader, const std::string& file)
+{
+	GLint compiled = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (compiled == GL_TRUE)
+		return;
+	GLint length = 0;
+	glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+	std::vector<GLchar> log(length > 0 ? length : 1, 0);
+	glGetShaderInfoLog(shader, (GLsizei)log.size(), NULL, log.data());
+	std::cerr << "ERROR: Failed to compile " << file << std::endl << log.data() << std::endl;
+}
+
+// Returns true if file is source or is included by it, directly or not
+bool ShaderLibrary::DependsOn(const std::string& source, const std::string& file, int depth) const
+{
+	if (source == file)
+		return true;
+	std::unordered_map<std::string, std::vector<std::string> >::const_iterator it = includes.find(source);
+	if (it == includes.end() || depth >= MAX_INCLUDE_DEPTH)
+		return false;
+	for (size_t i = 0; i < it->second.size(); i++)
+	{
+		if (DependsOn(it->second[i], file, depth + 1))
+			return true;
+	}
+	return false;
+}
+
+// Compiles and links every queued permutation, returns false if any of them failed
+bool ShaderLibrary::Build()
+{
+	std::vector<uint64_t> keys;
+	for (size_t i = 0; i < requested.size(); i++)
+	{
+		if (permutations.count(requested[i]) == 0)
+			keys.push_back(requested[i]);
+	}
+	requested.clear();
+	bool replaced = false;
+	return Compile(keys, replaced);
+}
+
+// Rebuilds every permutation that reads file and swaps in the new programs
+bool ShaderLibrary::Reload(const std::string& file)
+{
+	std::vector<uint64_t> keys;
+	for (std::unordered_map<uint64_t, Shader>::iterator it = permutations.begin(); it != permutations.end(); ++it)
+	{
+		const ProgramSource& source = programs[(size_t)(it->first >> 32)];
+		if (DependsOn(source.vertexFile, file) || DependsOn(source.fragmentFile, file))
+			keys.push_back(it->first);
+	}
+	if (keys.empty())
+		return false;
+
+	// Read everything again, an edited include changes every file that pulls it in
+	resolved.clear();
+	bool replaced = false;
+	Compile(keys, replaced);
+	return replaced;
+}
+
+// Compiles and links the given permutations, replacing those already built; returns false if any failed
+bool ShaderLibrary::Compile(const std::vector<uint64_t>& keys, bool& replaced)
+{
+	bool success = true;
+	std::vector<PendingBuild> pending;
+	pending.reserve(keys.size());
+
+	// Issue every compile without waiting on any of them
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		uint64_t key = keys[i];
+		bool queued = false;
+		for (size_t j = 0; j < pending.size() && !queued; j++)
+			queued = pending[j].key == key;
+		if (queued)
+			continue;
+
+		const ProgramSource& source = programs[(size_t)(key >> 32)];
+		GLuint mask = (GLuint)(key & 0xFFFFFFFFu);
+		std::string vertexCode, fragmentCode;
+		try
+		{
+			vertexCode = InjectDefines(Resolve(source.vertexFile), source.defines, mask);
+			fragmentCode = InjectDefines(Resolve(source.fragmentFile), source.defines, mask);
+		}
+		catch (int)
+		{
+			// get_file_contents already reported the missing file
+			success = false;
+			continue;
+		}
+
+		PendingBuild build;
+		build.key = key;
+		build.cacheKey = 0;
+		if (cache != NULL && cache->Supported)
+		{
+			std::vector<std::string> parts;
+			parts.push_back(vertexCode);
+			parts.push_back(fragmentCode);
+			build.cacheKey = cache->Key(parts);
+			GLuint program = cache->Load(build.cacheKey);
+			if (program != 0)
+			{
+				Replace(key, program, replaced);
+				continue;
+			}
+		}
+
+		const char* vertexSource = vertexCode.c_str();
+		const char* fragmentSource = fragmentCode.c_str();
+		build.vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		glShaderSource(build.vertexShader, 1, &vertexSource, NULL);
+		glCompileShader(build.vertexShader);
+		build.fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(build.fragmentShader, 1, &fragmentSource, NULL);
+		glCompileShader(build.fragmentShader);
+		pending.push_back(build);
+	}
+
+	// Then every link, a failed compile simply makes its link fail too
+	for (size_t i = 0; i < pending.size(); i++)
+	{
+		PendingBuild& build = pending[i];
+		build.program = glCreateProgram();
+		glAttachShader(build.program, build.vertexShader);
+		glAttachShader(build.program, build.fragmentShader);
+		if (cache != NULL && cache->Supported)
+			glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(build.program);
+	}
+
+	// Only now wait on the results
+	for (size_t i = 0; i < pending.size(); i++)
+	{
+		PendingBuild& build = pending[i];
+		const ProgramSource& source = programs[(size_t)(build.key >> 32)];
+		GLint linked = GL_FALSE;
+		glGetProgramiv(build.program, GL_LINK_STATUS, &linked);
+		if (linked == GL_TRUE)
+		{
+			if (cache != NULL)
+				cache->Store(build.cacheKey, build.program);
+			Replace(build.key, build.program, replaced);
+		}
+		else
+		{
+			ReportCompile(build.vertexShader, source.vertexFile);
+			ReportCompile(build.fragmentShader, source.fragmentFile);
+			GLint length = 0;
+			glGetProgramiv(build.program, GL_INFO_LOG_LENGTH, &length);
+			std::vector<GLchar> log(length > 0 ? length : 1, 0);
+			glGetProgramInfoLog(build.program, (GLsizei)log.size(), NULL, log.data());
+			std::cerr << "ERROR: Failed to link " << source.vertexFile << " + " << source.fragmentFile
+				<< " (defines 0x" << std::hex << (GLuint)(build.key & 0xFFFFFFFFu) << std::dec << ")" << std::endl
+				<< log.data() << std::endl;
+			glDeleteProgram(build.program);
+			success = false;
+		}
+		glDeleteShader(build.vertexShader);
+		glDeleteShader(build.fragmentShader);
+	}
+	return success;
+}
+
+// Stores a linked program as a permutation, deleting the program it replaces
+void ShaderLibrary::Replace(uint64_t key, GLuint program, bool& replaced)
+{
+	std::unordered_map<uint64_t, Shader>::iterator found = permutations.find(key);
+	if (found == permutations.end())
+	{
+		permutations.insert(std::make_pair(key, Shader(program)));
+		return;
+	}
+	// Callers hold on to the Shader, so the new program goes into the same object
+	found->second.Delete();
+	found->second = Shader(program);
+	replaced = true;
+}
+
+// Returns a built permutation, NULL if it was never requested or failed to build
+Shader* ShaderLibrary::Get(GLuint program, GLuint mask)
+{
+	std::unordered_map<uint64_t, Shader>::iterator found = permutations.find(PermutationKey(program, mask));
+	return found != permutations.end() ? &found->second : NULL;
+}
+
+// Deletes every permutation
+void ShaderLibrary::Delete()
+{
+	for (std::unordered_map<uint64_t, Shader>::iterator it = permutations.begin(); it != permutations.end(); ++it)
+		it->second.Delete();
+	permutations.clear();
+	requested.clear();
+}
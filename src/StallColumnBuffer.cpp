@@ -0,0 +1,77 @@
+#include"Header_Files/StallColumnBuffer.h"
+#include"Header_Files/GLStateCache.h"
+
+// The columns are uploaded as they are, so their elements must be tightly packed
+static_assert(sizeof(glm::vec3) == 3 * sizeof(GLfloat), "placement column must be tightly packed");
+static_assert(sizeof(glm::vec2) == 2 * sizeof(GLfloat), "size column must be tightly packed");
+
+// Constructor that generates empty column buffers
+StallColumnBuffer::StallColumnBuffer()
+	: Placements(GL_ARRAY_BUFFER, NULL, 0), Sizes(GL_ARRAY_BUFFER, NULL, 0),
+	States(GL_ARRAY_BUFFER, NULL, 0), Sprites(GL_ARRAY_BUFFER, NULL, 0)
+{
+	Count = 0;
+}
+
+// Uploads the columns of a level, only sending what differs from the last upload
+void StallColumnBuffer::Upload(const GarageLevelView& level)
+{
+	GLsizei count = (GLsizei)level.stallCount;
+	if (count < Count)
+	{
+		Placements.Resize(count * sizeof(glm::vec3));
+		Sizes.Resize(count * sizeof(glm::vec2));
+		States.Resize(count * sizeof(GLuint));
+		Sprites.Resize(count * sizeof(GLuint));
+	}
+	if (count > 0)
+	{
+		Placements.WriteChanged(0, level.placements, count * sizeof(glm::vec3), sizeof(glm::vec3));
+		Sizes.WriteChanged(0, level.sizes, count * sizeof(glm::vec2), sizeof(glm::vec2));
+		States.WriteChanged(0, level.states, count * sizeof(GLuint), sizeof(GLuint));
+		Sprites.WriteChanged(0, level.sprites, count * sizeof(GLuint), sizeof(GLuint));
+	}
+	Placements.Flush();
+	Sizes.Flush();
+	States.Flush();
+	Sprites.Flush();
+	Count = count;
+}
+
+// Links the columns to the VAO with the attribute layout of StallInstanceBuffer::LinkAttribs
+// firstLayout     : placement column, x, y, angle (vec3)
+// firstLayout + 1 : size column, width, depth (vec2)
+// firstLayout + 2 : state column (uint)
+// firstLayout + 3 : sprite column (uint)
+void StallColumnBuffer::LinkAttribs(VAO& VAO, GLuint firstLayout)
+{
+	VAO.Bind();
+	Placements.Bind();
+	glVertexAttribPointer(firstLayout, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	glEnableVertexAttribArray(firstLayout);
+	glVertexAttribDivisor(firstLayout, 1);
+	Sizes.Bind();
+	glVertexAttribPointer(firstLayout + 1, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	glEnableVertexAttribArray(firstLayout + 1);
+	glVertexAttribDivisor(firstLayout + 1, 1);
+	// Integer attributes need the I variant so the value is not converted to float
+	States.Bind();
+	glVertexAttribIPointer(firstLayout + 2, 1, GL_UNSIGNED_INT, 0, (void*)0);
+	glEnableVertexAttribArray(firstLayout + 2);
+	glVertexAttribDivisor(firstLayout + 2, 1);
+	Sprites.Bind();
+	glVertexAttribIPointer(firstLayout + 3, 1, GL_UNSIGNED_INT, 0, (void*)0);
+	glEnableVertexAttribArray(firstLayout + 3);
+	glVertexAttribDivisor(firstLayout + 3, 1);
+	VAO.Unbind();
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Deletes the column buffers
+void StallColumnBuffer::Delete()
+{
+	Placements.Delete();
+	Sizes.Delete();
+	States.Delete();
+	Sprites.Delete();
+}
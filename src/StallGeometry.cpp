@@ -0,0 +1,162 @@
+#include"Header_Files/StallGeometry.h"
+#include<cmath>
+
+// Every corner is the stall's centre plus a fixed offset, so a row is one pattern of STALL_ROW_FLOATS
+// floats moved by step per stall; xMask and yMask are 1 where the pattern holds an x or a y
+static void row_pattern(const StallRow& row, GLfloat pattern[STALL_ROW_FLOATS], GLfloat xMask[STALL_ROW_FLOATS], GLfloat yMask[STALL_ROW_FLOATS], glm::vec2& step)
+{
+	float sine = sinf(row.angle);
+	float turn = atan2f(row.direction.y, row.direction.x) + row.angle - 1.57079633f;
+	glm::vec2 widthAxis(cosf(turn), sinf(turn)), depthAxis(-widthAxis.y, widthAxis.x);
+	widthAxis *= 0.5f * row.width;
+	depthAxis *= 0.5f * row.depth;
+	// Stalls touch side by side, so the row advances a width measured across the slant
+	step = row.direction * (row.width / sine);
+
+	static const float corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { -1.0f, 1.0f }, { 1.0f, 1.0f } };
+	for (int c = 0; c < 4; c++)
+	{
+		glm::vec2 offset = widthAxis * corners[c][0] + depthAxis * corners[c][1];
+		GLfloat vertex[STALL_VERTEX_FLOATS] = { offset.x, offset.y, 0.0f, 0.5f + 0.5f * corners[c][0], 0.5f + 0.5f * corners[c][1] };
+		for (int f = 0; f < STALL_VERTEX_FLOATS; f++)
+		{
+			pattern[c * STALL_VERTEX_FLOATS + f] = vertex[f];
+			xMask[c * STALL_VERTEX_FLOATS + f] = f == 0 ? 1.0f : 0.0f;
+			yMask[c * STALL_VERTEX_FLOATS + f] = f == 1 ? 1.0f : 0.0f;
+		}
+	}
+}
+
+// Writes stalls first to count of a row, one at a time
+static void scalar_stalls(const StallRow& row, const GLfloat* pattern, glm::vec2 step, GLuint first, GLfloat* vertices)
+{
+	for (GLuint k = first; k < row.count; k++)
+	{
+		GLfloat centerX = row.origin.x + step.x * (GLfloat)k;
+		GLfloat centerY = row.origin.y + step.y * (GLfloat)k;
+		GLfloat* out = vertices + (size_t)k * STALL_ROW_FLOATS;
+		for (int c = 0; c < 4; c++)
+		{
+			const GLfloat* in = pattern + c * STALL_VERTEX_FLOATS;
+			out[c * STALL_VERTEX_FLOATS + 0] = in[0] + centerX;
+			out[c * STALL_VERTEX_FLOATS + 1] = in[1] + centerY;
+			out[c * STALL_VERTEX_FLOATS + 2] = in[2];
+			out[c * STALL_VERTEX_FLOATS + 3] = in[3];
+			out[c * STALL_VERTEX_FLOATS + 4] = in[4];
+		}
+	}
+}
+
+#if GLM_ARCH & GLM_ARCH_AVX2_BIT
+
+// Eight stalls per step: their centres fill one register, and each pair of stalls is 40 floats,
+// five registers, whose lanes pick the centre of the stall they belong to. Multiplies and adds
+// are kept apart, FMA is a separate extension that -mavx2 alone does not enable
+void stall_row_vertices(const StallRow& row, GLfloat* vertices)
+{
+	GLfloat pattern[STALL_ROW_FLOATS], xMask[STALL_ROW_FLOATS], yMask[STALL_ROW_FLOATS];
+	glm::vec2 step;
+	row_pattern(row, pattern, xMask, yMask, step);
+
+	__m256 pairPattern[5], pairX[5], pairY[5];
+	__m256i pairLane[5];
+	for (int j = 0; j < 5; j++)
+	{
+		alignas(32) GLfloat p[8], x[8], y[8];
+		alignas(32) int lane[8];
+		for (int l = 0; l < 8; l++)
+		{
+			int f = j * 8 + l;
+			p[l] = pattern[f % STALL_ROW_FLOATS];
+			x[l] = xMask[f % STALL_ROW_FLOATS];
+			y[l] = yMask[f % STALL_ROW_FLOATS];
+			lane[l] = f < STALL_ROW_FLOATS ? 0 : 1;
+		}
+		pairPattern[j] = _mm256_load_ps(p);
+		pairX[j] = _mm256_load_ps(x);
+		pairY[j] = _mm256_load_ps(y);
+		pairLane[j] = _mm256_load_si256((const __m256i*)lane);
+	}
+
+	const __m256 ramp = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256 originX = _mm256_set1_ps(row.origin.x), originY = _mm256_set1_ps(row.origin.y);
+	const __m256 stepX = _mm256_set1_ps(step.x), stepY = _mm256_set1_ps(step.y);
+	GLuint k = 0;
+	for (; k + 8 <= row.count; k += 8)
+	{
+		__m256 index = _mm256_add_ps(_mm256_set1_ps((GLfloat)k), ramp);
+		__m256 centerX = _mm256_add_ps(_mm256_mul_ps(stepX, index), originX);
+		__m256 centerY = _mm256_add_ps(_mm256_mul_ps(stepY, index), originY);
+		GLfloat* out = vertices + (size_t)k * STALL_ROW_FLOATS;
+		for (int pair = 0; pair < 4; pair++)
+		{
+			__m256i first = _mm256_set1_epi32(2 * pair);
+			for (int j = 0; j < 5; j++)
+			{
+				__m256i lane = _mm256_add_epi32(pairLane[j], first);
+				__m256 x = _mm256_permutevar8x32_ps(centerX, lane);
+				__m256 y = _mm256_permutevar8x32_ps(centerY, lane);
+				__m256 value = _mm256_add_ps(_mm256_mul_ps(x, pairX[j]), _mm256_add_ps(_mm256_mul_ps(y, pairY[j]), pairPattern[j]));
+				_mm256_storeu_ps(out + (pair * 5 + j) * 8, value);
+			}
+		}
+	}
+	scalar_stalls(row, pattern, step, k, vertices);
+}
+
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+// Writes the 20 floats of the stall in lane of centerX and centerY
+#define STALL_ROW_SSE_LANE(lane) \
+	{ \
+		glm_vec4 x = _mm_shuffle_ps(centerX, centerX, _MM_SHUFFLE(lane, lane, lane, lane)); \
+		glm_vec4 y = _mm_shuffle_ps(centerY, centerY, _MM_SHUFFLE(lane, lane, lane, lane)); \
+		for (int j = 0; j < 5; j++) \
+			_mm_storeu_ps(out + (lane * 5 + j) * 4, glm_vec4_fma(x, stallX[j], glm_vec4_fma(y, stallY[j], stallPattern[j]))); \
+	}
+
+// Four stalls per step: their centres fill one register and each stall is five registers
+void stall_row_vertices(const StallRow& row, GLfloat* vertices)
+{
+	GLfloat pattern[STALL_ROW_FLOATS], xMask[STALL_ROW_FLOATS], yMask[STALL_ROW_FLOATS];
+	glm::vec2 step;
+	row_pattern(row, pattern, xMask, yMask, step);
+
+	glm_vec4 stallPattern[5], stallX[5], stallY[5];
+	for (int j = 0; j < 5; j++)
+	{
+		stallPattern[j] = _mm_loadu_ps(pattern + j * 4);
+		stallX[j] = _mm_loadu_ps(xMask + j * 4);
+		stallY[j] = _mm_loadu_ps(yMask + j * 4);
+	}
+
+	const glm_vec4 ramp = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+	const glm_vec4 originX = _mm_set1_ps(row.origin.x), originY = _mm_set1_ps(row.origin.y);
+	const glm_vec4 stepX = _mm_set1_ps(step.x), stepY = _mm_set1_ps(step.y);
+	GLuint k = 0;
+	for (; k + 4 <= row.count; k += 4)
+	{
+		glm_vec4 index = glm_vec4_add(_mm_set1_ps((GLfloat)k), ramp);
+		glm_vec4 centerX = glm_vec4_fma(stepX, index, originX);
+		glm_vec4 centerY = glm_vec4_fma(stepY, index, originY);
+		GLfloat* out = vertices + (size_t)k * STALL_ROW_FLOATS;
+		STALL_ROW_SSE_LANE(0)
+		STALL_ROW_SSE_LANE(1)
+		STALL_ROW_SSE_LANE(2)
+		STALL_ROW_SSE_LANE(3)
+	}
+	scalar_stalls(row, pattern, step, k, vertices);
+}
+
+#else
+
+// Writes the four corners of every stall of a row
+void stall_row_vertices(const StallRow& row, GLfloat* vertices)
+{
+	GLfloat pattern[STALL_ROW_FLOATS], xMask[STALL_ROW_FLOATS], yMask[STALL_ROW_FLOATS];
+	glm::vec2 step;
+	row_pattern(row, pattern, xMask, yMask, step);
+	scalar_stalls(row, pattern, step, 0, vertices);
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include"Header_Files/StallInstanceBuffer.h"
+#include"Header_Files/GLStateCache.h"
+
+// Constructor that generates an instance buffer and uploads the stalls to it
+StallInstanceBuffer::StallInstanceBuffer(const StallInstance* instances, GLsizei count)
+	: Storage(GL_ARRAY_BUFFER, instances, count * sizeof(StallInstance))
+{
+	ID = Storage.ID;
+	Count = count;
+	Capacity = count;
+}
+
+// Replaces the stored stalls, uploading only the records that differ from the stored ones
+void StallInstanceBuffer::Update(const StallInstance* instances, GLsizei count)
+{
+	// Storage grows by itself and is uploaded whole once too much of it changed
+	if (count < Count)
+		Storage.Resize(count * sizeof(StallInstance));
+	Storage.WriteChanged(0, instances, count * sizeof(StallInstance), sizeof(StallInstance));
+	Storage.Flush();
+	Count = count;
+	Capacity = (GLsizei)(Storage.Capacity / sizeof(StallInstance));
+}
+
+// Replaces a single stored stall, uploaded by the next Update or Flush
+void StallInstanceBuffer::Set(GLsizei index, const StallInstance& instance)
+{
+	Storage.WriteChanged(index * sizeof(StallInstance), &instance, sizeof(StallInstance), sizeof(StallInstance));
+	Count = (GLsizei)(Storage.Size / sizeof(StallInstance));
+}
+
+// Uploads the records changed by Set
+void StallInstanceBuffer::Flush()
+{
+	Storage.Flush();
+	Capacity = (GLsizei)(Storage.Capacity / sizeof(StallInstance));
+}
+
+// Links the per-instance attributes to the VAO starting at a certain layout
+void StallInstanceBuffer::LinkAttribs(VAO& VAO, GLuint firstLayout)
+{
+	LinkAttribs(VAO, ID, 0, firstLayout);
+}
+
+// Links StallInstance attributes stored at offset in any buffer, e.g. a StreamingVBO region
+// firstLayout     : x, y, angle (vec3)
+// firstLayout + 1 : width, depth (vec2)
+// firstLayout + 2 : state (uint)
+// firstLayout + 3 : sprite (uint)
+void StallInstanceBuffer::LinkAttribs(VAO& VAO, GLuint buffer, GLintptr offset, GLuint firstLayout)
+{
+	VAO.Bind();
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, buffer);
+	GLsizei stride = sizeof(StallInstance);
+	glVertexAttribPointer(firstLayout, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(StallInstance, x)));
+	glEnableVertexAttribArray(firstLayout);
+	glVertexAttribDivisor(firstLayout, 1);
+	glVertexAttribPointer(firstLayout + 1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(StallInstance, width)));
+	glEnableVertexAttribArray(firstLayout + 1);
+	glVertexAttribDivisor(firstLayout + 1, 1);
+	// Integer attributes need the I variant so the value is not converted to float
+	glVertexAttribIPointer(firstLayout + 2, 1, GL_UNSIGNED_INT, stride, (void*)(offset + offsetof(StallInstance, state)));
+	glEnableVertexAttribArray(firstLayout + 2);
+	glVertexAttribDivisor(firstLayout + 2, 1);
+	glVertexAttribIPointer(firstLayout + 3, 1, GL_UNSIGNED_INT, stride, (void*)(offset + offsetof(StallInstance, sprite)));
+	glEnableVertexAttribArray(firstLayout + 3);
+	glVertexAttribDivisor(firstLayout + 3, 1);
+	VAO.Unbind();
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Draws every stored stall with a single instanced draw call (VAO must be bound)
+void StallInstanceBuffer::Draw(GLsizei indexCount)
+{
+	if (Count > 0)
+		glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0, Count);
+}
+
+// Binds the instance buffer
+void StallInstanceBuffer::Bind()
+{
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, ID);
+}
+
+// Unbinds the instance buffer
+void StallInstanceBuffer::Unbind()
+{
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Deletes the instance buffer
+void StallInstanceBuffer::Delete()
+{
+	Storage.Delete();
+}
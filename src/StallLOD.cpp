@@ -0,0 +1,186 @@
+#include"Header_Files/StallLOD.h"
+#include<algorithm>
+#include<cfloat>
+#include<cmath>
+#include<cstdint>
+#include<unordered_map>
+#include<utility>
+
+// Stall states that count as taken in an aggregate: occupied and reserved
+static const GLuint OCCUPIED = 1;
+static const GLuint RESERVED = 2;
+
+// Returns true if a stall in state counts as taken
+static bool is_taken(GLuint state)
+{
+	return state == OCCUPIED || state == RESERVED;
+}
+
+// Returns the rounded percentage of total stalls that taken is
+static GLuint percent_taken(GLuint taken, GLuint total)
+{
+	return total == 0 ? 0 : (100 * taken + total / 2) / total;
+}
+
+// Returns the bounds (min x, min y, max x, max y) of a stall whatever its rotation
+static glm::vec4 stall_bounds(const StallInstance& stall)
+{
+	float radius = 0.5f * sqrtf(stall.width * stall.width + stall.depth * stall.depth);
+	return glm::vec4(stall.x - radius, stall.y - radius, stall.x + radius, stall.y + radius);
+}
+
+// Constructor that starts without levels
+StallLOD::StallLOD(float minPixels)
+{
+	MinPixels = minPixels;
+}
+
+// Rebuilds every level from the stalls
+void StallLOD::Build(const std::vector<StallInstance>& stalls)
+{
+	levels.clear();
+	if (stalls.empty())
+	{
+		levels.push_back(Level(glm::vec2(0.0f), glm::vec2(1.0f)));
+		return;
+	}
+
+	// The stalls' index is made once their bounds are known
+	Level base(glm::vec2(0.0f), glm::vec2(1.0f));
+	base.elements = stalls;
+	base.bounds.resize(stalls.size());
+	base.totals.assign(stalls.size(), 1);
+	base.taken.resize(stalls.size());
+	glm::vec2 worldMin(stalls[0].x, stalls[0].y), worldMax = worldMin;
+	float sizeSum = 0.0f;
+	for (size_t i = 0; i < stalls.size(); i++)
+	{
+		base.bounds[i] = stall_bounds(stalls[i]);
+		base.taken[i] = is_taken(stalls[i].state) ? 1 : 0;
+		worldMin = glm::min(worldMin, glm::vec2(base.bounds[i]));
+		worldMax = glm::max(worldMax, glm::vec2(base.bounds[i].z, base.bounds[i].w));
+		sizeSum += std::max(stalls[i].width, stalls[i].depth);
+	}
+	base.tree = LooseQuadtree(worldMin, worldMax);
+	base.size = sizeSum / (float)stalls.size();
+	for (size_t i = 0; i < stalls.size(); i++)
+		base.tree.Insert((GLuint)i, base.bounds[i]);
+	levels.push_back(std::move(base));
+
+	// The first aggregates group a few stalls across, each level above doubles the cell
+	float cell = 4.0f * levels[0].size;
+	for (int k = 0; k < MAX_AGGREGATE_LEVELS && levels.back().elements.size() > 1; k++)
+	{
+		// Group the elements of the level below by the cell their centre falls in
+		Level& below = levels.back();
+		Level level(worldMin, worldMax);
+		level.size = cell;
+		std::unordered_map<uint64_t, GLuint> cells;
+		below.parents.resize(below.elements.size());
+		for (size_t i = 0; i < below.elements.size(); i++)
+		{
+			const glm::vec4& bounds = below.bounds[i];
+			glm::vec2 center = 0.5f * (glm::vec2(bounds) + glm::vec2(bounds.z, bounds.w));
+			uint64_t key = ((uint64_t)(GLuint)((center.y - worldMin.y) / cell) << 32) | (GLuint)((center.x - worldMin.x) / cell);
+			std::pair<std::unordered_map<uint64_t, GLuint>::iterator, bool> found = cells.insert(std::make_pair(key, (GLuint)level.bounds.size()));
+			if (found.second)
+			{
+				level.bounds.push_back(bounds);
+				level.totals.push_back(0);
+				level.taken.push_back(0);
+			}
+			GLuint group = found.first->second;
+			level.bounds[group] = glm::vec4(glm::min(glm::vec2(level.bounds[group]), glm::vec2(bounds)),
+				glm::max(glm::vec2(level.bounds[group].z, level.bounds[group].w), glm::vec2(bounds.z, bounds.w)));
+			level.totals[group] += below.totals[i];
+			level.taken[group] += below.taken[i];
+			below.parents[i] = group;
+		}
+
+		// One axis-aligned quad per group, outlined by the stall shader like a stall
+		for (size_t g = 0; g < level.bounds.size(); g++)
+		{
+			StallInstance aggregate;
+			aggregate.x = 0.5f * (level.bounds[g].x + level.bounds[g].z);
+			aggregate.y = 0.5f * (level.bounds[g].y + level.bounds[g].w);
+			aggregate.angle = 0.0f;
+			aggregate.width = level.bounds[g].z - level.bounds[g].x;
+			aggregate.depth = level.bounds[g].w - level.bounds[g].y;
+			aggregate.state = percent_taken(level.taken[g], level.totals[g]);
+			aggregate.sprite = NO_SPRITE;
+			level.elements.push_back(aggregate);
+			level.tree.Insert((GLuint)g, level.bounds[g]);
+		}
+		levels.push_back(std::move(level));
+		cell *= 2.0f;
+	}
+}
+
+// Number of levels, 1 (the stalls alone) for small layouts
+int StallLOD::Levels() const
+{
+	return (int)levels.size();
+}
+
+// Returns the level to draw at pixelsPerUnit screen pixels per layout unit
+int StallLOD::SelectLevel(float pixelsPerUnit) const
+{
+	for (size_t k = 0; k < levels.size(); k++)
+	{
+		if (levels[k].size * pixelsPerUnit >= MinPixels)
+			return (int)k;
+	}
+	return levels.empty() ? 0 : (int)levels.size() - 1;
+}
+
+// Appends the elements of level overlapping rect (min x, min y, max x, max y)
+void StallLOD::Query(int level, const glm::vec4& rect, std::vector<StallInstance>& elements) const
+{
+	if (level < 0 || level >= (int)levels.size())
+		return;
+	ids.clear();
+	levels[level].tree.Query(rect, ids);
+	for (size_t i = 0; i < ids.size(); i++)
+		elements.push_back(levels[level].elements[ids[i]]);
+}
+
+// Sets the state of a stall and updates the aggregates above it; changed[k] receives the bounds
+// of the element that changed on level k, or an empty rectangle, and stays empty if nothing did
+void StallLOD::SetState(GLuint stall, GLuint state, std::vector<glm::vec4>& changed)
+{
+	changed.clear();
+	if (levels.empty() || stall >= levels[0].elements.size() || levels[0].elements[stall].state == state)
+		return;
+	changed.assign(levels.size(), glm::vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX));
+	Level& base = levels[0];
+	base.elements[stall].state = state;
+	changed[0] = base.bounds[stall];
+	GLuint nowTaken = is_taken(state) ? 1 : 0;
+	if (nowTaken == base.taken[stall])
+		return;
+	base.taken[stall] = nowTaken;
+
+	// Walk up the groups holding the stall, each of them has one stall more or less taken
+	GLuint element = stall;
+	for (size_t k = 1; k < levels.size(); k++)
+	{
+		element = levels[k - 1].parents[element];
+		Level& level = levels[k];
+		level.taken[element] = nowTaken ? level.taken[element] + 1 : level.taken[element] - 1;
+		GLuint percent = percent_taken(level.taken[element], level.totals[element]);
+		if (percent != level.elements[element].state)
+		{
+			level.elements[element].state = percent;
+			changed[k] = level.bounds[element];
+		}
+	}
+}
+
+// Range of pixels per unit [minimum, maximum) that SelectLevel picks level for
+void StallLOD::PixelsPerUnitRange(int level, float& minimum, float& maximum) const
+{
+	// A level is picked once its elements reach MinPixels and the level below's do not
+	bool last = level + 1 >= (int)levels.size();
+	minimum = last ? 0.0f : MinPixels / levels[level].size;
+	maximum = level == 0 ? FLT_MAX : MinPixels / levels[level - 1].size;
+}
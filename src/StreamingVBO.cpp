@@ -0,0 +1,105 @@
+#include"Header_Files/StreamingVBO.h"
+#include"Header_Files/GLStateCache.h"
+
+// Offsets handed out by Allocate are aligned so any vertex attribute type can start there
+static const GLsizeiptr ALLOCATION_ALIGNMENT = 16;
+
+// Constructor that generates a Vertex Buffer Object with regionCount regions of regionSize bytes
+StreamingVBO::StreamingVBO(GLsizeiptr regionSize, GLuint regionCount)
+{
+	RegionSize = (regionSize + ALLOCATION_ALIGNMENT - 1) & ~(ALLOCATION_ALIGNMENT - 1);
+	RegionCount = regionCount;
+	Region = 0;
+	fences.assign(regionCount, (GLsync)0);
+	mapped = NULL;
+	used = 0;
+	glGenBuffers(1, &ID);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, ID);
+	glBufferData(GL_ARRAY_BUFFER, RegionSize * RegionCount, NULL, GL_STREAM_DRAW);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Waits until the current region is free and maps it for writing
+void StreamingVBO::BeginFrame()
+{
+	// Wait for the GPU to finish the frame that last read from this region
+	GLsync fence = fences[Region];
+	if (fence != 0)
+	{
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (true)
+		{
+			GLenum result = glClientWaitSync(fence, flags, 1000000);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+				break;
+			flags = 0;
+		}
+		glDeleteSync(fence);
+		fences[Region] = 0;
+	}
+
+	// The fence already guarantees the region is idle, so skip the driver's own synchronization
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, ID);
+	mapped = (char*)glMapBufferRange(GL_ARRAY_BUFFER, Region * RegionSize, RegionSize,
+		GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+	used = 0;
+}
+
+// Sub-allocates size bytes from the current region, returns NULL if the region is full
+void* StreamingVBO::Allocate(GLsizeiptr size, GLintptr& offset)
+{
+	if (mapped == NULL || used + size > RegionSize)
+		return NULL;
+	void* ptr = mapped + used;
+	offset = Region * RegionSize + used;
+	used = (used + size + ALLOCATION_ALIGNMENT - 1) & ~(ALLOCATION_ALIGNMENT - 1);
+	return ptr;
+}
+
+// Flushes the written bytes and unmaps the region, must be called before drawing
+void StreamingVBO::Unmap()
+{
+	if (mapped == NULL)
+		return;
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, ID);
+	if (used > 0)
+		glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, used);
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+	mapped = NULL;
+}
+
+// Fences the current region after this frame's draws and moves to the next one
+void StreamingVBO::EndFrame()
+{
+	Unmap();
+	fences[Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	Region = (Region + 1) % RegionCount;
+}
+
+// Binds the VBO
+void StreamingVBO::Bind()
+{
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, ID);
+}
+
+// Unbinds the VBO
+void StreamingVBO::Unbind()
+{
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Deletes the VBO and its fences
+void StreamingVBO::Delete()
+{
+	Unmap();
+	for (size_t i = 0; i < fences.size(); i++)
+	{
+		if (fences[i] != 0)
+			glDeleteSync(fences[i]);
+		fences[i] = 0;
+	}
+	GLStateCache::Current().ForgetBuffer(ID);
+	glDeleteBuffers(1, &ID);
+}
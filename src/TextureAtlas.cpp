@@ -0,0 +1,183 @@
+#include"Header_Files/TextureAtlas.h"
+#include"Header_Files/GLStateCache.h"
+#include"Header_Files/AssetVFS.h"
+#include<stb/stb_image.h>
+#include<algorithm>
+#include<climits>
+#include<cstring>
+#include<iostream>
+
+// Constructor that creates an empty atlas, padding pixels are left around every sprite
+TextureAtlas::TextureAtlas(GLsizei width, GLsizei height, int padding)
+{
+	ID = 0;
+	Width = width;
+	Height = height;
+	this->padding = padding;
+	pixels.assign((size_t)width * height * 4, 0);
+	SkylineNode start = { 0, 0, width };
+	skyline.push_back(start);
+}
+
+// Finds the lowest position for a width x height rectangle, returns the node it starts at or -1
+int TextureAtlas::FindPosition(int width, int height, int& x, int& y) const
+{
+	int bestNode = -1;
+	int bestY = INT_MAX;
+	int bestWidth = INT_MAX;
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		int left = skyline[i].x;
+		if (left + width > Width)
+			break;
+		// The rectangle rests on the highest node it spans
+		int top = 0;
+		int remaining = width;
+		for (size_t j = i; remaining > 0; j++)
+		{
+			top = std::max(top, skyline[j].y);
+			remaining -= skyline[j].width;
+		}
+		if (top + height > Height)
+			continue;
+		// Prefer the lowest spot, then the narrowest node to keep gaps small
+		if (top < bestY || (top == bestY && skyline[i].width < bestWidth))
+		{
+			bestNode = (int)i;
+			bestY = top;
+			bestWidth = skyline[i].width;
+			x = left;
+			y = top;
+		}
+	}
+	return bestNode;
+}
+
+// Raises the skyline over a placed rectangle
+void TextureAtlas::Place(int node, int x, int y, int width, int height)
+{
+	SkylineNode raised = { x, y + height, width };
+	skyline.insert(skyline.begin() + node, raised);
+
+	// Trim or remove the nodes now covered by the new one
+	size_t i = node + 1;
+	while (i < skyline.size())
+	{
+		int coveredEnd = raised.x + raised.width;
+		if (skyline[i].x >= coveredEnd)
+			break;
+		int shrink = coveredEnd - skyline[i].x;
+		if (shrink >= skyline[i].width)
+		{
+			skyline.erase(skyline.begin() + i);
+			continue;
+		}
+		skyline[i].x += shrink;
+		skyline[i].width -= shrink;
+		break;
+	}
+
+	// Merge neighbours of equal height
+	for (size_t j = 0; j + 1 < skyline.size();)
+	{
+		if (skyline[j].y == skyline[j + 1].y)
+		{
+			skyline[j].width += skyline[j + 1].width;
+			skyline.erase(skyline.begin() + j + 1);
+		}
+		else
+			j++;
+	}
+}
+
+// Packs an RGBA image and returns its sprite index, or -1 if it does not fit
+int TextureAtlas::Add(const unsigned char* rgba, int width, int height)
+{
+	if (UVRects.size() >= MAX_ATLAS_SPRITES)
+		return -1;
+	int x = 0, y = 0;
+	int node = FindPosition(width + 2 * padding, height + 2 * padding, x, y);
+	if (node < 0)
+		return -1;
+	Place(node, x, y, width + 2 * padding, height + 2 * padding);
+
+	int left = x + padding;
+	int bottom = y + padding;
+	for (int row = 0; row < height; row++)
+		memcpy(&pixels[((size_t)(bottom + row) * Width + left) * 4], rgba + (size_t)row * width * 4, (size_t)width * 4);
+
+	// Sample texel centres only so neighbouring sprites never bleed in
+	glm::vec4 rect((left + 0.5f) / Width, (bottom + 0.5f) / Height, (left + width - 0.5f) / Width, (bottom + height - 0.5f) / Height);
+	UVRects.push_back(rect);
+	return (int)UVRects.size() - 1;
+}
+
+// Loads and packs image files tallest first, returns the sprite index of each file (-1 on failure)
+std::vector<int> TextureAtlas::AddFiles(const std::vector<std::string>& paths)
+{
+	struct Image
+	{
+		size_t index;
+		int width, height;
+		unsigned char* pixels;
+	};
+	std::vector<Image> images;
+	std::vector<int> sprites(paths.size(), -1);
+
+	stbi_set_flip_vertically_on_load_thread(1);
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		Image image;
+		int channels;
+		image.index = i;
+		std::string_view packed;
+		if (AssetVFS::Default().Find(paths[i], packed))
+			image.pixels = stbi_load_from_memory((const stbi_uc*)packed.data(), (int)packed.size(), &image.width, &image.height, &channels, 4);
+		else
+			image.pixels = stbi_load(AssetVFS::Default().Resolve(paths[i]).c_str(), &image.width, &image.height, &channels, 4);
+		if (image.pixels == NULL)
+		{
+			std::cerr << "ERROR: Failed to load sprite: " << paths[i] << std::endl;
+			continue;
+		}
+		images.push_back(image);
+	}
+
+	// Skyline packing wastes the least space when taller images go first
+	std::stable_sort(images.begin(), images.end(), [](const Image& a, const Image& b) { return a.height > b.height; });
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		sprites[images[i].index] = Add(images[i].pixels, images[i].width, images[i].height);
+		if (sprites[images[i].index] < 0)
+			std::cerr << "ERROR: Sprite does not fit in the atlas: " << paths[images[i].index] << std::endl;
+		stbi_image_free(images[i].pixels);
+	}
+	return sprites;
+}
+
+// Creates the texture from the packed pixels
+void TextureAtlas::Upload()
+{
+	if (ID == 0)
+		glGenTextures(1, &ID);
+	GLStateCache::Current().BindTexture(GL_TEXTURE_2D, ID);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Width, Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	// No mipmaps: lower levels would average neighbouring sprites together
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	GLStateCache::Current().BindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Deletes the atlas texture
+void TextureAtlas::Delete()
+{
+	if (ID != 0)
+	{
+		GLStateCache::Current().ForgetTexture(ID);
+		glDeleteTextures(1, &ID);
+	}
+	ID = 0;
+}
@@ -0,0 +1,305 @@
+#include"Header_Files/TextureCache.h"
+#include<sys/stat.h>
+#include<climits>
+#include<cstdio>
+#include<cstring>
+#include<fstream>
+#include<functional>
+#include<thread>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+// Identifies cache files and their layout version
+static const char CACHE_MAGIC[8] = { 'P', 'A', 'L', 'T', 'E', 'X', 0, 2 };
+// Pixel data offsets are rounded up to this so mapped levels are well aligned
+static const uint64_t CACHE_ALIGNMENT = 16;
+// Bytes hashed at each end of a source, so a rewrite that keeps its size and time is still noticed
+static const size_t HASHED_BLOCK = 64 * 1024;
+
+// Fixed-size start of every cache file, followed by the source path and the level table
+struct TextureCacheHeader
+{
+	char magic[8];
+	uint32_t channels;
+	uint32_t levelCount;
+	int64_t sourceModified;
+	uint64_t sourceSize;
+	uint64_t sourceHash;
+	uint32_t pathLength;
+	uint32_t reserved;
+};
+
+// Entry of the level table
+struct TextureCacheLevel
+{
+	uint32_t width;
+	uint32_t height;
+	uint64_t offset;
+	uint64_t size;
+};
+
+// Rounds value up to CACHE_ALIGNMENT
+static uint64_t align_up(uint64_t value)
+{
+	return (value + CACHE_ALIGNMENT - 1) & ~(CACHE_ALIGNMENT - 1);
+}
+
+// 64-bit FNV-1a hash, continuing from hash
+static uint64_t fnv1a(const void* data, size_t length, uint64_t hash = 14695981039346656037ull)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Constructor that uses directory for the cache, creating it if needed
+TextureCache::TextureCache(const std::string& directory)
+{
+	Directory = directory;
+#ifdef _WIN32
+	_mkdir(directory.c_str());
+#else
+	mkdir(directory.c_str(), 0755);
+#endif
+}
+
+// Maps the cached copy of sourcePath if it exists and the source has not changed since
+bool TextureCache::Find(const std::string& sourcePath, CachedImage& image) const
+{
+	Version version;
+	return FileVersion(sourcePath, version) && Find(version, image);
+}
+
+// Maps the cached copy of a packed asset if it exists and its bytes have not changed since
+bool TextureCache::Find(const std::string& name, std::string_view bytes, CachedImage& image) const
+{
+	Version version;
+	PackedVersion(name, bytes, version);
+	return Find(version, image);
+}
+
+// Stores decoded pixels (bottom row first), with a box-filtered mip chain if mipmaps is set
+bool TextureCache::Store(const std::string& sourcePath, const unsigned char* pixels, int width, int height, int channels, bool mipmaps) const
+{
+	Version version;
+	return FileVersion(sourcePath, version) && Store(version, pixels, width, height, channels, mipmaps);
+}
+
+// Same as Store, for pixels decoded from the bytes of a packed asset
+bool TextureCache::Store(const std::string& name, std::string_view bytes, const unsigned char* pixels, int width, int height, int channels, bool mipmaps) const
+{
+	Version version;
+	PackedVersion(name, bytes, version);
+	return Store(version, pixels, width, height, channels, mipmaps);
+}
+
+// Identifies the current version of a file on disk, returns false if it is missing
+bool TextureCache::FileVersion(const std::string& sourcePath, Version& version)
+{
+	struct stat info;
+	if (stat(sourcePath.c_str(), &info) != 0)
+		return false;
+	version.name = sourcePath;
+	version.modified = (int64_t)info.st_mtime;
+	version.size = (uint64_t)info.st_size;
+
+	// The first and last blocks are hashed too, mtimes are coarse on some file systems and copies keep them
+	std::ifstream in(sourcePath.c_str(), std::ios::binary);
+	if (!in)
+		return false;
+	std::vector<char> block(version.size < 2 * HASHED_BLOCK ? (size_t)version.size : HASHED_BLOCK);
+	in.read(block.data(), block.size());
+	version.contentHash = fnv1a(block.data(), (size_t)in.gcount());
+	// Sources smaller than two blocks were read whole above
+	if (version.size >= 2 * HASHED_BLOCK)
+	{
+		in.seekg((std::streamoff)(version.size - HASHED_BLOCK));
+		in.read(block.data(), block.size());
+		version.contentHash = fnv1a(block.data(), (size_t)in.gcount(), version.contentHash);
+	}
+	return true;
+}
+
+// Identifies the bytes of a packed asset; the name is marked so a loose file of the same path gets its own entry
+void TextureCache::PackedVersion(const std::string& name, std::string_view bytes, Version& version)
+{
+	version.name = "pack:" + name;
+	version.modified = 0;
+	version.size = bytes.size();
+	if (bytes.size() < 2 * HASHED_BLOCK)
+		version.contentHash = fnv1a(bytes.data(), bytes.size());
+	else
+	{
+		version.contentHash = fnv1a(bytes.data(), HASHED_BLOCK);
+		version.contentHash = fnv1a(bytes.data() + bytes.size() - HASHED_BLOCK, HASHED_BLOCK, version.contentHash);
+	}
+}
+
+// Returns the cache file for a version of a source
+std::string TextureCache::EntryPath(const Version& version) const
+{
+	uint64_t hash = fnv1a(version.name.data(), version.name.size());
+	hash = fnv1a(&version.modified, sizeof(version.modified), hash);
+	hash = fnv1a(&version.size, sizeof(version.size), hash);
+	hash = fnv1a(&version.contentHash, sizeof(version.contentHash), hash);
+	char name[32];
+	snprintf(name, sizeof(name), "/%016llx.tex", (unsigned long long)hash);
+	return Directory + name;
+}
+
+// Maps the cache entry of a version if it exists and is intact
+bool TextureCache::Find(const Version& version, CachedImage& image) const
+{
+	const std::string& sourcePath = version.name;
+	std::string path = EntryPath(version);
+	if (!image.File.Open(path))
+		return false;
+
+	// Validate everything before trusting any offset in the file
+	const unsigned char* data = image.File.Data;
+	size_t fileSize = image.File.Size;
+	TextureCacheHeader header;
+	bool valid = fileSize >= sizeof(header);
+	if (valid)
+	{
+		memcpy(&header, data, sizeof(header));
+		valid = memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0
+			&& header.sourceModified == version.modified && header.sourceSize == version.size && header.sourceHash == version.contentHash
+			&& header.channels >= 1 && header.channels <= 4
+			&& header.levelCount >= 1 && header.levelCount <= 32
+			&& header.pathLength == sourcePath.size()
+			&& sizeof(header) + header.pathLength <= fileSize
+			&& memcmp(data + sizeof(header), sourcePath.data(), sourcePath.size()) == 0;
+	}
+	uint64_t tableOffset = valid ? align_up(sizeof(header) + header.pathLength) : 0;
+	if (valid)
+		valid = tableOffset + header.levelCount * sizeof(TextureCacheLevel) <= fileSize;
+
+	image.Levels.clear();
+	for (uint32_t i = 0; valid && i < header.levelCount; i++)
+	{
+		TextureCacheLevel level;
+		memcpy(&level, data + tableOffset + i * sizeof(level), sizeof(level));
+		// Dimensions must fit an int and halve from the level above, and offset + size must not wrap
+		valid = level.width >= 1 && level.width <= INT_MAX && level.height >= 1 && level.height <= INT_MAX
+			&& level.offset <= fileSize && level.size <= fileSize - level.offset
+			&& level.size == (uint64_t)level.width * level.height * header.channels;
+		if (valid && i > 0)
+		{
+			uint32_t width = (uint32_t)image.Levels.back().width, height = (uint32_t)image.Levels.back().height;
+			valid = level.width == (width > 1 ? width / 2 : 1) && level.height == (height > 1 ? height / 2 : 1);
+		}
+		CachedLevel cached = { (int)level.width, (int)level.height, data + level.offset };
+		image.Levels.push_back(cached);
+	}
+	if (!valid)
+	{
+		image.File.Close();
+		image.Levels.clear();
+		return false;
+	}
+	image.Channels = (int)header.channels;
+	return true;
+}
+
+// Writes the cache entry of a version
+bool TextureCache::Store(const Version& version, const unsigned char* pixels, int width, int height, int channels, bool mipmaps) const
+{
+	const std::string& sourcePath = version.name;
+	std::string path = EntryPath(version);
+
+	// Level 0 is the source, every further level halves it down to 1x1
+	std::vector<std::vector<unsigned char> > chain;
+	std::vector<TextureCacheLevel> levels;
+	TextureCacheLevel base = { (uint32_t)width, (uint32_t)height, 0, (uint64_t)width * height * channels };
+	levels.push_back(base);
+	while (mipmaps && (levels.back().width > 1 || levels.back().height > 1))
+	{
+		const TextureCacheLevel& src = levels.back();
+		const unsigned char* srcPixels = chain.empty() ? pixels : chain.back().data();
+		TextureCacheLevel dst;
+		dst.width = src.width > 1 ? src.width / 2 : 1;
+		dst.height = src.height > 1 ? src.height / 2 : 1;
+		dst.offset = 0;
+		dst.size = (uint64_t)dst.width * dst.height * channels;
+		std::vector<unsigned char> out(dst.size);
+		for (uint32_t y = 0; y < dst.height; y++)
+		{
+			uint32_t y0 = y * 2 < src.height ? y * 2 : src.height - 1;
+			uint32_t y1 = y * 2 + 1 < src.height ? y * 2 + 1 : y0;
+			for (uint32_t x = 0; x < dst.width; x++)
+			{
+				uint32_t x0 = x * 2 < src.width ? x * 2 : src.width - 1;
+				uint32_t x1 = x * 2 + 1 < src.width ? x * 2 + 1 : x0;
+				for (int c = 0; c < channels; c++)
+				{
+					unsigned sum = srcPixels[((size_t)y0 * src.width + x0) * channels + c]
+						+ srcPixels[((size_t)y0 * src.width + x1) * channels + c]
+						+ srcPixels[((size_t)y1 * src.width + x0) * channels + c]
+						+ srcPixels[((size_t)y1 * src.width + x1) * channels + c];
+					out[((size_t)y * dst.width + x) * channels + c] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+		chain.push_back(out);
+		levels.push_back(dst);
+	}
+
+	TextureCacheHeader header;
+	memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.channels = (uint32_t)channels;
+	header.levelCount = (uint32_t)levels.size();
+	header.sourceModified = version.modified;
+	header.sourceSize = version.size;
+	header.sourceHash = version.contentHash;
+	header.pathLength = (uint32_t)sourcePath.size();
+	header.reserved = 0;
+	uint64_t offset = align_up(align_up(sizeof(header) + header.pathLength) + levels.size() * sizeof(TextureCacheLevel));
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		levels[i].offset = offset;
+		offset = align_up(offset + levels[i].size);
+	}
+
+	// Write to a temporary name first so a crash never leaves a truncated entry behind
+	std::string temporary = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+	{
+		std::ofstream out(temporary.c_str(), std::ios::binary);
+		if (!out)
+			return false;
+		static const char zeros[CACHE_ALIGNMENT] = { 0 };
+		uint64_t written = 0;
+		out.write((const char*)&header, sizeof(header));
+		out.write(sourcePath.data(), sourcePath.size());
+		written = sizeof(header) + sourcePath.size();
+		out.write(zeros, align_up(written) - written);
+		written = align_up(written);
+		out.write((const char*)levels.data(), levels.size() * sizeof(TextureCacheLevel));
+		written += levels.size() * sizeof(TextureCacheLevel);
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			out.write(zeros, levels[i].offset - written);
+			const unsigned char* data = i == 0 ? pixels : chain[i - 1].data();
+			out.write((const char*)data, levels[i].size);
+			written = levels[i].offset + levels[i].size;
+		}
+		if (!out)
+		{
+			out.close();
+			remove(temporary.c_str());
+			return false;
+		}
+	}
+	remove(path.c_str());
+	if (rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,357 @@
+#include"Header_Files/TextureManager.h"
+#include"Header_Files/GLStateCache.h"
+#include"Header_Files/AssetVFS.h"
+#include<stb/stb_image.h>
+#include<chrono>
+#include<cstring>
+#include<iostream>
+
+// Bytes staged per glTexSubImage2D call, large images take several calls and frames
+static const size_t UPLOAD_CHUNK_BYTES = 1 << 20;
+
+// Returns the GL pixel format for a channel count
+static GLenum channel_format(int channels)
+{
+	switch (channels)
+	{
+	case 1: return GL_RED;
+	case 2: return GL_RG;
+	case 4: return GL_RGBA;
+	default: return GL_RGB;
+	}
+}
+
+// Constructor that creates the placeholder and the staging buffer
+TextureManager::TextureManager(ThreadPool& pool, double uploadBudgetMs, TextureCache* cache) : pool(pool)
+{
+	this->cache = cache;
+	UploadBudget = uploadBudgetMs;
+
+	const unsigned char checker[16] =
+	{
+		200, 0, 200, 255,   60, 60, 60, 255,
+		60, 60, 60, 255,    200, 0, 200, 255
+	};
+	glGenTextures(1, &Placeholder);
+	GLStateCache::Current().BindTexture(GL_TEXTURE_2D, Placeholder);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, checker);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	GLStateCache::Current().BindTexture(GL_TEXTURE_2D, 0);
+
+	glGenBuffers(1, &stagingBuffer);
+}
+
+// Starts loading an image file and returns its handle immediately
+TextureHandle TextureManager::Load(const std::string& path, GLint filter, GLint wrap)
+{
+	TextureHandle handle;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		handle = (TextureHandle)entries.size();
+		entries.push_back(Entry());
+		Entry& entry = entries.back();
+		entry.path = path;
+		entry.filter = filter;
+		entry.wrap = wrap;
+		entry.id = 0;
+		entry.live = 0;
+		entry.state = DECODING;
+		entry.stale = false;
+		entry.width = entry.height = entry.channels = 0;
+		entry.pixels = NULL;
+		entry.decoded = NULL;
+		entry.uploadedRows = 0;
+	}
+	queue.push_back(handle);
+	pool.Enqueue([this, handle] { Decode(handle); });
+	return handle;
+}
+
+// Loads every texture read from path again, returns false if none uses path
+bool TextureManager::Reload(const std::string& path)
+{
+	bool found = false;
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		Entry& entry = entries[i];
+		if (entry.path != path)
+			continue;
+		found = true;
+		if (entry.state != READY && entry.state != FAILED)
+		{
+			// Still loading the previous version, start over once that finishes
+			entry.stale = true;
+			continue;
+		}
+		entry.state = DECODING;
+		entry.id = 0;
+		entry.uploadedRows = 0;
+		queue.push_back((TextureHandle)i);
+		TextureHandle handle = (TextureHandle)i;
+		pool.Enqueue([this, handle] { Decode(handle); });
+	}
+	return found;
+}
+
+// Decodes one image on a worker thread
+void TextureManager::Decode(TextureHandle handle)
+{
+	std::string path;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		path = entries[handle].path;
+	}
+
+	// A cache hit skips decoding, the levels are used straight from the mapped file. Packed
+	// assets are cached by their bytes, loose ones by the file they are read from
+	std::string diskPath = AssetVFS::Default().Resolve(path);
+	std::string_view packed;
+	bool isPacked = AssetVFS::Default().Find(path, packed);
+	CachedImage cached;
+	if (cache != NULL && (isPacked ? cache->Find(path, packed, cached) : cache->Find(diskPath, cached)))
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		Entry& entry = entries[handle];
+		entry.cached = cached;
+		entry.pixels = cached.Levels[0].pixels;
+		entry.width = cached.Levels[0].width;
+		entry.height = cached.Levels[0].height;
+		entry.channels = cached.Channels;
+		entry.state = DECODED;
+		return;
+	}
+
+	// OpenGL expects the bottom row first; the flag is per thread so workers do not race
+	stbi_set_flip_vertically_on_load_thread(1);
+	int width, height, channels;
+	unsigned char* pixels;
+	if (isPacked)
+		pixels = stbi_load_from_memory((const stbi_uc*)packed.data(), (int)packed.size(), &width, &height, &channels, 0);
+	else
+		pixels = stbi_load(diskPath.c_str(), &width, &height, &channels, 0);
+	if (pixels == NULL)
+		std::cerr << "ERROR: Failed to load texture: " << path << " (" << stbi_failure_reason() << ")" << std::endl;
+	else if (cache != NULL && isPacked)
+		cache->Store(path, packed, pixels, width, height, channels, true);
+	else if (cache != NULL)
+		cache->Store(diskPath, pixels, width, height, channels, true);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	Entry& entry = entries[handle];
+	entry.pixels = pixels;
+	entry.decoded = pixels;
+	entry.width = width;
+	entry.height = height;
+	entry.channels = channels;
+	entry.state = pixels != NULL ? DECODED : FAILED;
+}
+
+// Uploads the next rows of a decoded image, returns true when it is complete
+bool TextureManager::UploadRows(Entry& entry, int rows)
+{
+	GLenum format = channel_format(entry.channels);
+	GLStateCache& state = GLStateCache::Current();
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if (entry.state == DECODED)
+	{
+		// Allocate the full image once, the rows are filled in by the chunks below
+		glGenTextures(1, &entry.id);
+		state.BindTexture(GL_TEXTURE_2D, entry.id);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, entry.filter == GL_NEAREST ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, entry.filter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, entry.wrap);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, entry.wrap);
+		glTexImage2D(GL_TEXTURE_2D, 0, format, entry.width, entry.height, 0, format, GL_UNSIGNED_BYTE, NULL);
+		entry.state = UPLOADING;
+	}
+	else
+	{
+		state.BindTexture(GL_TEXTURE_2D, entry.id);
+	}
+
+	size_t rowBytes = (size_t)entry.width * entry.channels;
+	if (rows > entry.height - entry.uploadedRows)
+		rows = entry.height - entry.uploadedRows;
+	size_t bytes = rowBytes * rows;
+
+	// Orphan the staging storage so the copy never waits on the previous chunk
+	state.BindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+	void* staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (staging != NULL)
+	{
+		memcpy(staging, entry.pixels + rowBytes * entry.uploadedRows, bytes);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, entry.uploadedRows, entry.width, rows, format, GL_UNSIGNED_BYTE, (void*)0);
+	}
+	else
+	{
+		// Mapping failed, upload straight from client memory instead
+		state.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, entry.uploadedRows, entry.width, rows, format, GL_UNSIGNED_BYTE, entry.pixels + rowBytes * entry.uploadedRows);
+	}
+	state.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	entry.uploadedRows += rows;
+
+	bool complete = entry.uploadedRows >= entry.height;
+	if (complete && entry.cached.Levels.size() > 1)
+	{
+		// Cached mip levels are small next to level 0 and go straight from the mapping
+		for (size_t level = 1; level < entry.cached.Levels.size(); level++)
+		{
+			const CachedLevel& mip = entry.cached.Levels[level];
+			glTexImage2D(GL_TEXTURE_2D, (GLint)level, format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE, mip.pixels);
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)entry.cached.Levels.size() - 1);
+	}
+	else if (complete)
+		glGenerateMipmap(GL_TEXTURE_2D);
+	state.BindTexture(GL_TEXTURE_2D, 0);
+	return complete;
+}
+
+// Uploads decoded images within the budget, call once per frame on the GL thread
+void TextureManager::Update()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	size_t next = 0;
+	while (next < queue.size())
+	{
+		TextureHandle handle = queue[next];
+		std::unique_lock<std::mutex> lock(mutex);
+		Entry& entry = entries[handle];
+		if (entry.state == FAILED)
+		{
+			queue.erase(queue.begin() + next);
+			if (entry.stale)
+			{
+				entry.stale = false;
+				lock.unlock();
+				Reload(entry.path);
+			}
+			continue;
+		}
+		if (entry.state == DECODING)
+		{
+			// Later images may already be decoded, do not wait behind this one
+			next++;
+			continue;
+		}
+		lock.unlock();
+
+		int rows = (int)(UPLOAD_CHUNK_BYTES / ((size_t)entry.width * entry.channels));
+		if (rows < 1)
+			rows = 1;
+		bool complete = UploadRows(entry, rows);
+
+		lock.lock();
+		bool stale = false;
+		if (complete)
+		{
+			ReleasePixels(entry);
+			// Swap the finished texture in, a reload retires the one it replaces
+			if (entry.live != 0 && entry.live != entry.id)
+			{
+				GLStateCache::Current().ForgetTexture(entry.live);
+				glDeleteTextures(1, &entry.live);
+			}
+			entry.live = entry.id;
+			entry.state = READY;
+			stale = entry.stale;
+			entry.stale = false;
+			queue.erase(queue.begin() + next);
+		}
+		lock.unlock();
+		if (stale)
+			Reload(entry.path);
+
+		// Always make some progress, then stop once the budget is spent
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (elapsed >= UploadBudget)
+			break;
+	}
+}
+
+// Releases the decoded or mapped pixels of an entry
+void TextureManager::ReleasePixels(Entry& entry)
+{
+	if (entry.decoded != NULL)
+		stbi_image_free(entry.decoded);
+	entry.cached.File.Close();
+	entry.cached.Levels.clear();
+	entry.decoded = NULL;
+	entry.pixels = NULL;
+}
+
+// Blocks until every texture is decoded and uploaded
+void TextureManager::Finish()
+{
+	pool.Wait();
+	double budget = UploadBudget;
+	UploadBudget = 1e30;
+	while (!queue.empty())
+		Update();
+	UploadBudget = budget;
+}
+
+// Returns the texture ID for a handle, or Placeholder while it is still loading
+GLuint TextureManager::GetID(TextureHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (handle >= entries.size() || entries[handle].live == 0)
+		return Placeholder;
+	return entries[handle].live;
+}
+
+// Returns true once the texture is uploaded
+bool TextureManager::IsReady(TextureHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return handle < entries.size() && entries[handle].live != 0;
+}
+
+// Returns true if the image could not be loaded
+bool TextureManager::Failed(TextureHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return handle < entries.size() && entries[handle].state == FAILED;
+}
+
+// Number of textures not uploaded yet
+size_t TextureManager::Pending() const
+{
+	return queue.size();
+}
+
+// Deletes every texture, the placeholder and the staging buffer
+void TextureManager::Delete()
+{
+	// Workers may still be writing into entries
+	pool.Wait();
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (entries[i].id != 0 && entries[i].id != entries[i].live)
+		{
+			GLStateCache::Current().ForgetTexture(entries[i].id);
+			glDeleteTextures(1, &entries[i].id);
+		}
+		if (entries[i].live != 0)
+		{
+			GLStateCache::Current().ForgetTexture(entries[i].live);
+			glDeleteTextures(1, &entries[i].live);
+		}
+		ReleasePixels(entries[i]);
+		entries[i].id = 0;
+		entries[i].live = 0;
+	}
+	queue.clear();
+	GLStateCache::Current().ForgetTexture(Placeholder);
+	glDeleteTextures(1, &Placeholder);
+	GLStateCache::Current().ForgetBuffer(stagingBuffer);
+	glDeleteBuffers(1, &stagingBuffer);
+}
@@ -0,0 +1,78 @@
+#include"Header_Files/ThreadPool.h"
+
+// Constructor that starts threadCount workers, 0 for one per hardware thread
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+	active = 0;
+	stopping = false;
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+	if (threadCount == 0)
+		threadCount = 2;
+	for (unsigned int i = 0; i < threadCount; i++)
+		workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+}
+
+// Number of worker threads
+unsigned int ThreadPool::Size() const
+{
+	return (unsigned int)workers.size();
+}
+
+// Queues a task to run on one of the workers
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(task);
+		active++;
+	}
+	wake.notify_one();
+}
+
+// Blocks until every queued task has finished
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [this] { return active == 0; });
+}
+
+// Finishes the queued tasks and stops the workers
+void ThreadPool::Delete()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		if (workers[i].joinable())
+			workers[i].join();
+	}
+	workers.clear();
+}
+
+// Body of each worker thread
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty())
+				return;
+			task.swap(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			active--;
+			if (active == 0)
+				idle.notify_all();
+		}
+	}
+}
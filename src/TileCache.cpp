@@ -0,0 +1,232 @@
+#include"Header_Files/TileCache.h"
+#include"Header_Files/GLStateCache.h"
+#include<algorithm>
+#include<cmath>
+
+// Returns true if two (min x, min y, max x, max y) rectangles overlap
+static bool overlaps(const glm::vec4& a, const glm::vec4& b)
+{
+	return a.x <= b.z && b.x <= a.z && a.y <= b.w && b.y <= a.w;
+}
+
+// Constructor that creates the composite quads, tiles are made on demand
+TileCache::TileCache(GLsizei tilePixels, size_t maxTiles)
+{
+	TilePixels = tilePixels;
+	MaxTiles = maxTiles;
+	ClearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	Visible = 0;
+	Rendered = 0;
+	bounds = glm::vec4(0.0f);
+	frame = 0;
+	quadCapacity = maxTiles;
+
+	// Two triangles per tile quad, the vertices are written by Update
+	std::vector<GLuint> indices;
+	for (GLuint i = 0; i < (GLuint)maxTiles; i++)
+	{
+		GLuint quad[] = { 0, 1, 3, 0, 3, 2 };
+		for (int j = 0; j < 6; j++)
+			indices.push_back(4 * i + quad[j]);
+	}
+	glGenVertexArrays(1, &vao);
+	glGenBuffers(1, &vbo);
+	glGenBuffers(1, &ebo);
+	GLStateCache::Current().BindVertexArray(vao);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, maxTiles * 4 * 5 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
+	GLStateCache::Current().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	// Same layout as the textured quad: position (x, y, z) then texture coordinates (u, v)
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+	GLStateCache::Current().BindVertexArray(0);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+	GLStateCache::Current().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// Packs a level and tile position into a map key
+uint64_t TileCache::TileKey(int level, GLuint x, GLuint y)
+{
+	return ((uint64_t)level << 48) | ((uint64_t)y << 24) | (uint64_t)x;
+}
+
+// World rectangle (min x, min y, max x, max y) of the static layer, drops every tile
+void TileCache::SetBounds(const glm::vec4& bounds)
+{
+	this->bounds = bounds;
+	tiles.clear();
+	freeTargets.clear();
+	for (size_t i = 0; i < targets.size(); i++)
+		freeTargets.push_back(i);
+}
+
+// Marks the tiles overlapping rect for redrawing, on the levels whose tiles are minSize to maxSize wide
+void TileCache::Invalidate(const glm::vec4& rect, float minSize, float maxSize)
+{
+	for (std::unordered_map<uint64_t, Tile>::iterator it = tiles.begin(); it != tiles.end(); ++it)
+	{
+		float size = it->second.rect.z - it->second.rect.x;
+		if (size >= minSize && size <= maxSize && overlaps(it->second.rect, rect))
+			it->second.dirty = true;
+	}
+}
+
+// Marks every tile for redrawing
+void TileCache::InvalidateAll()
+{
+	for (std::unordered_map<uint64_t, Tile>::iterator it = tiles.begin(); it != tiles.end(); ++it)
+		it->second.dirty = true;
+}
+
+// Returns a free FBO for a new tile, reusing the least recently shown one, or -1 if none can be had
+long TileCache::AcquireTarget()
+{
+	if (!freeTargets.empty())
+	{
+		size_t target = freeTargets.back();
+		freeTargets.pop_back();
+		return (long)target;
+	}
+	if (targets.size() < std::min(MaxTiles, quadCapacity))
+	{
+		FBO target(TilePixels, TilePixels);
+		if (target.IsComplete())
+		{
+			targets.push_back(target);
+			return (long)targets.size() - 1;
+		}
+		// The driver will not give us more, make do with the tiles we have
+		target.Delete();
+		MaxTiles = targets.size();
+	}
+
+	// Take over the tile shown longest ago, tiles in view this frame are kept
+	std::unordered_map<uint64_t, Tile>::iterator oldest = tiles.end();
+	for (std::unordered_map<uint64_t, Tile>::iterator it = tiles.begin(); it != tiles.end(); ++it)
+	{
+		if (it->second.lastUsed != frame && (oldest == tiles.end() || it->second.lastUsed < oldest->second.lastUsed))
+			oldest = it;
+	}
+	if (oldest == tiles.end())
+		return -1;
+	size_t target = oldest->second.target;
+	tiles.erase(oldest);
+	return (long)target;
+}
+
+// Picks the level for pixelsPerUnit screen pixels per world unit and draws the missing and
+// invalidated tiles overlapping visibleRect, calling drawTile(tile rect) with the tile's FBO bound
+void TileCache::Update(const glm::vec4& visibleRect, float pixelsPerUnit, const std::function<void(const glm::vec4&)>& drawTile)
+{
+	frame++;
+	visibleTextures.clear();
+	vertices.clear();
+	Visible = 0;
+	Rendered = 0;
+	float extent = std::max(bounds.z - bounds.x, bounds.w - bounds.y);
+	glm::vec4 rect(std::max(visibleRect.x, bounds.x), std::max(visibleRect.y, bounds.y),
+		std::min(visibleRect.z, bounds.z), std::min(visibleRect.w, bounds.w));
+	if (extent <= 0.0f || pixelsPerUnit <= 0.0f || rect.x > rect.z || rect.y > rect.w)
+		return;
+
+	// Coarsest level whose tiles have at least as many pixels per unit as the screen
+	int level = (int)ceilf(log2f(pixelsPerUnit * extent / (float)TilePixels));
+	level = std::min(std::max(level, 0), MAX_LEVEL);
+	GLuint tilesPerSide = 1u << level;
+	float tileSize = extent / (float)tilesPerSide;
+	GLuint minX = std::min((GLuint)((rect.x - bounds.x) / tileSize), tilesPerSide - 1);
+	GLuint minY = std::min((GLuint)((rect.y - bounds.y) / tileSize), tilesPerSide - 1);
+	GLuint maxX = std::min((GLuint)((rect.z - bounds.x) / tileSize), tilesPerSide - 1);
+	GLuint maxY = std::min((GLuint)((rect.w - bounds.y) / tileSize), tilesPerSide - 1);
+
+	GLint viewport[4];
+	bool drawing = false;
+	for (GLuint y = minY; y <= maxY; y++)
+	{
+		for (GLuint x = minX; x <= maxX && visibleTextures.size() < std::min(MaxTiles, quadCapacity); x++)
+		{
+			uint64_t key = TileKey(level, x, y);
+			std::unordered_map<uint64_t, Tile>::iterator it = tiles.find(key);
+			if (it == tiles.end())
+			{
+				long target = AcquireTarget();
+				if (target < 0)
+					continue;
+				Tile tile;
+				tile.rect = glm::vec4(bounds.x + x * tileSize, bounds.y + y * tileSize,
+					bounds.x + (x + 1) * tileSize, bounds.y + (y + 1) * tileSize);
+				tile.target = (size_t)target;
+				tile.dirty = true;
+				it = tiles.insert(std::make_pair(key, tile)).first;
+			}
+			Tile& tile = it->second;
+			tile.lastUsed = frame;
+			if (tile.dirty)
+			{
+				// The window's viewport is put back once every tile is drawn
+				if (!drawing)
+				{
+					glGetIntegerv(GL_VIEWPORT, viewport);
+					drawing = true;
+				}
+				targets[tile.target].Bind();
+				glClearColor(ClearColor.r, ClearColor.g, ClearColor.b, ClearColor.a);
+				glClear(GL_COLOR_BUFFER_BIT);
+				drawTile(tile.rect);
+				tile.dirty = false;
+				Rendered++;
+			}
+
+			// Texture rows start at the bottom, like the tile's projection
+			GLfloat quad[] =
+			{
+				tile.rect.x, tile.rect.y, 0.0f, 0.0f, 0.0f,
+				tile.rect.z, tile.rect.y, 0.0f, 1.0f, 0.0f,
+				tile.rect.x, tile.rect.w, 0.0f, 0.0f, 1.0f,
+				tile.rect.z, tile.rect.w, 0.0f, 1.0f, 1.0f,
+			};
+			vertices.insert(vertices.end(), quad, quad + 20);
+			visibleTextures.push_back(targets[tile.target].ColorTexture);
+		}
+	}
+	if (drawing)
+	{
+		targets[0].Unbind();
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	}
+	Visible = visibleTextures.size();
+
+	if (!vertices.empty())
+	{
+		GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(GLfloat), vertices.data());
+		GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+}
+
+// Records one textured quad per tile in view, program samples tex0 like default.frag
+void TileCache::Record(RenderQueue& queue, uint8_t layer, GLuint program)
+{
+	for (size_t i = 0; i < visibleTextures.size(); i++)
+		queue.Push(RenderQueue::Indexed(layer, program, visibleTextures[i], vao, 6, (GLintptr)(i * 6 * sizeof(GLuint))));
+}
+
+// Deletes every tile and the composite quads
+void TileCache::Delete()
+{
+	for (size_t i = 0; i < targets.size(); i++)
+		targets[i].Delete();
+	targets.clear();
+	tiles.clear();
+	freeTargets.clear();
+	visibleTextures.clear();
+	GLStateCache::Current().ForgetVertexArray(vao);
+	GLStateCache::Current().ForgetBuffer(vbo);
+	GLStateCache::Current().ForgetBuffer(ebo);
+	glDeleteVertexArrays(1, &vao);
+	glDeleteBuffers(1, &vbo);
+	glDeleteBuffers(1, &ebo);
+}
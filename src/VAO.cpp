@@ -1,4 +1,5 @@
 #include"Header_Files/VAO.h"
+#include"Header_Files/GLStateCache.h"
 
 // Constructor that generates a VAO ID
 VAO::VAO()
@@ -15,20 +16,30 @@ void VAO::LinkVBO(VBO& VBO, GLuint layout)
 	VBO.Unbind();
 }
 
+// Links a VBO attribute to the VAO using a layout, component count, type, stride and offset
+void VAO::LinkAttrib(VBO& VBO, GLuint layout, GLuint numComponents, GLenum type, GLsizeiptr stride, void* offset)
+{
+	VBO.Bind();
+	glVertexAttribPointer(layout, numComponents, type, GL_FALSE, stride, offset);
+	glEnableVertexAttribArray(layout);
+	VBO.Unbind();
+}
+
 // Binds the VAO
 void VAO::Bind()
 {
-	glBindVertexArray(ID);
+	GLStateCache::Current().BindVertexArray(ID);
 }
 
 // Unbinds the VAO
 void VAO::Unbind()
 {
-	glBindVertexArray(0);
+	GLStateCache::Current().BindVertexArray(0);
 }
 
 // Deletes the VAO
 void VAO::Delete()
 {
+	GLStateCache::Current().ForgetVertexArray(ID);
 	glDeleteVertexArrays(1, &ID);
 }
\ No newline at end of file
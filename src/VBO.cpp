@@ -1,27 +1,29 @@
 #include"Header_Files/VBO.h"
+#include"Header_Files/GLStateCache.h"
 
 // Constructor that generates a Vertex Buffer Object and links it to vertices
 VBO::VBO(GLfloat* vertices, GLsizeiptr size)
 {
 	glGenBuffers(1, &ID);
-	glBindBuffer(GL_ARRAY_BUFFER, ID);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, ID);
 	glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 }
 
 // Binds the VBO
 void VBO::Bind()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, ID);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, ID);
 }
 
 // Unbinds the VBO
 void VBO::Unbind()
 {
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	GLStateCache::Current().BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 // Deletes the VBO
 void VBO::Delete()
 {
+	GLStateCache::Current().ForgetBuffer(ID);
 	glDeleteBuffers(1, &ID);
 }
\ No newline at end of file
@@ -2,26 +2,339 @@
 #include <cmath>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
-#include <stb/stb_image.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 
 #include "Header_Files/shaderClass.h"
+#include "Header_Files/ShaderLibrary.h"
 #include "Header_Files/VAO.h"
 #include "Header_Files/VBO.h"
 #include "Header_Files/EBO.h"
+#include "Header_Files/StallInstanceBuffer.h"
+#include "Header_Files/StreamingVBO.h"
+#include "Header_Files/FrameUniforms.h"
+#include "Header_Files/GLStateCache.h"
+#include "Header_Files/RenderQueue.h"
+#include "Header_Files/FBO.h"
+#include "Header_Files/LayoutFile.h"
+#include "Header_Files/ImageWriter.h"
+#include "Header_Files/FrameCapture.h"
+#include "Header_Files/ThreadPool.h"
+#include "Header_Files/TextureManager.h"
+#include "Header_Files/TextureAtlas.h"
+#include "Header_Files/AssetVFS.h"
+#include "Header_Files/FileWatcher.h"
+#include "Header_Files/Profiler.h"
+#include "Header_Files/FrameScheduler.h"
+#include "Header_Files/Camera2D.h"
+#include "Header_Files/LooseQuadtree.h"
+#include "Header_Files/TileCache.h"
+#include "Header_Files/StallLOD.h"
+#include "Header_Files/GarageLayout.h"
+#include "Header_Files/StallColumnBuffer.h"
+#include "Header_Files/GarageFile.h"
+#include "Header_Files/LayoutGenerator.h"
+#include "Header_Files/OccupancySimulator.h"
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cfloat>
+#include <chrono>
+#include <random>
 
 using namespace std;
 
+// Prints the command line options
+static void print_usage(const char* program)
+{
+    cout << "Usage: " << program << " [--pack <assets.pak>] [--convert <output.garage | output.txt>] [--generate <site file> <output layout>] [--simulate <days>] [--seed <n>] [--record <video.y4m | png directory>] [--headless <output dir> [--size <pixels>]] [<layout file>...]" << endl;
+}
+
+// Saves a layout in the binary format if path ends in .garage, as text otherwise
+static bool save_layout(const string& path, const GarageLayout& layout)
+{
+    bool binary = path.size() >= 7 && path.compare(path.size() - 7, 7, ".garage") == 0;
+    return binary ? GarageFile::Write(path, layout) : save_garage_layout(path, layout);
+}
+
+// Same as save_layout for levels given as views, e.g. straight from a mapped binary file
+static bool save_layout_levels(const string& path, const vector<string>& names, const vector<GarageLevelView>& views)
+{
+    bool binary = path.size() >= 7 && path.compare(path.size() - 7, 7, ".garage") == 0;
+    return binary ? GarageFile::Write(path, names, views) : save_garage_levels(path, names, views);
+}
+
+// Copies a level of the mapped file into the layout the viewer shows, the first time it is needed
+static bool load_viewed_level(int level, GarageFile& file, GarageLayout& layout, vector<bool>& loaded)
+{
+    if (loaded[level])
+        return true;
+    if (!file.Fill(level, layout))
+        return false;
+    loaded[level] = true;
+    return true;
+}
 
+// Opens a layout file for the viewer. A binary file stays mapped in file and only its first level
+// is copied into layout, the others follow through load_viewed_level when they are shown; a text
+// file is read whole. Returns false, leaving layout as it was, if the file cannot be read.
+static bool open_viewed_layout(const string& path, GarageFile& file, GarageLayout& layout, vector<bool>& loaded)
+{
+    GarageLayout opened;
+    vector<bool> openedLoaded;
+    GarageFile mapped;
+    if (GarageFile::Detect(path))
+    {
+        if (!mapped.Open(path))
+            return false;
+        mapped.Outline(opened);
+        openedLoaded.assign(opened.Levels.size(), false);
+        if (!opened.Levels.empty() && !load_viewed_level(0, mapped, opened, openedLoaded))
+        {
+            mapped.Close();
+            return false;
+        }
+    }
+    else if (!load_garage_layout(path, opened))
+        return false;
+    if (opened.Levels.empty())
+        opened.AddLevel("1");
+    openedLoaded.resize(opened.Levels.size(), true);
+
+    // The old mapping is only let go once the new file has been read
+    file.Close();
+    file = mapped;
+    layout = opened;
+    loaded = openedLoaded;
+    return true;
+}
+
+// Returns the output image path for a layout file: outDir/<layout name>.png, or
+// outDir/<layout name>_<level number>.png for the levels of a multi-level layout
+static string thumbnail_path(const string& outDir, const string& layoutPath, int level = -1)
+{
+    size_t slash = layoutPath.find_last_of("\\/");
+    string name = slash == string::npos ? layoutPath : layoutPath.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    if (dot != string::npos && dot > 0)
+        name = name.substr(0, dot);
+    if (level >= 0)
+        name += "_" + to_string(level + 1);
+    return outDir + "/" + name + ".png";
+}
 
-int main()
+// Returns the bounds (min x, min y, max x, max y) of a stall or vehicle
+static glm::vec4 instance_bounds(const StallInstance& instance)
+{
+    // Half the diagonal bounds the stall whatever its rotation
+    float radius = 0.5f * sqrtf(instance.width * instance.width + instance.depth * instance.depth);
+    return glm::vec4(instance.x - radius, instance.y - radius, instance.x + radius, instance.y + radius);
+}
+
+// Orthographic projection that fits a level's bounds into a square image with a small margin
+static glm::mat4 fit_layout_projection(const glm::vec4& bounds)
+{
+    float centerX = 0.5f * (bounds.x + bounds.z);
+    float centerY = 0.5f * (bounds.y + bounds.w);
+    float half = 0.55f * fmaxf(bounds.z - bounds.x, bounds.w - bounds.y);
+    return glm::ortho(centerX - half, centerX + half, centerY - half, centerY + half, -1.0f, 1.0f);
+}
+
+// Demo level: two facing rows of stalls along the bottom of the window, and the aisle the cars drive along
+static void build_demo_garage(GarageLayout& garage)
+{
+    garage.Clear();
+    int level = garage.AddLevel("Demo");
+    garage.Reserve(level, 50);
+    for (int row = 0; row < 2; row++)
+    {
+        for (int i = 0; i < 25; i++)
+        {
+            StallInstance stall;
+            stall.x = 40.0f + i * 30.0f;
+            stall.y = 60.0f + row * 55.0f;
+            stall.angle = 0.0f;
+            stall.width = 30.0f;
+            stall.depth = 55.0f;
+            stall.state = (GLuint)((i * 7 + row * 3) % 4);
+            // Accessible stalls carry the first sprite of the atlas
+            stall.sprite = stall.state == 3 ? 0 : NO_SPRITE;
+            uint8_t type = stall.state == 3 ? STALL_ACCESSIBLE : STALL_STANDARD;
+            garage.AddStall(level, stall, type, string(1, (char)('A' + row)) + to_string(i + 1));
+        }
+    }
+    garage.AddAisle(level, glm::vec2(0.0f, 210.0f), glm::vec2(800.0f, 210.0f), 40.0f);
+}
+
+int main(int argc, char** argv)
 {
     float width = 800;
     float height = 800;
-    
+
+    // Headless mode renders each layout file into an offscreen image and exits
+    bool headless = false;
+    string outDir;
+    int imageSize = 512;
+    vector<string> layoutFiles;
+    string recordPath;
+    string packPath;
+    string convertPath;
+    string sitePath, generatedPath;
+    uint32_t seed = 1;
+    double simulateDays = 0.0;
+    // Two hundred years, so a typo cannot keep the simulator busy indefinitely
+    const double MAX_SIMULATE_DAYS = 365.0 * 200.0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc)
+        {
+            headless = true;
+            outDir = argv[++i];
+        }
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            imageSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc)
+            packPath = argv[++i];
+        else if (strcmp(argv[i], "--convert") == 0 && i + 1 < argc)
+            convertPath = argv[++i];
+        else if (strcmp(argv[i], "--generate") == 0 && i + 2 < argc)
+        {
+            sitePath = argv[++i];
+            generatedPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--simulate") == 0 && i + 1 < argc)
+        {
+            // Anything but a positive, finite number of days up to MAX_SIMULATE_DAYS is refused
+            char* end = NULL;
+            simulateDays = strtod(argv[++i], &end);
+            if (end == argv[i] || *end != '\0' || !std::isfinite(simulateDays) || !(simulateDays > 0.0) || simulateDays > MAX_SIMULATE_DAYS)
+            {
+                print_usage(argv[0]);
+                return -1;
+            }
+        }
+        else if (argv[i][0] == '-')
+        {
+            print_usage(argv[0]);
+            return -1;
+        }
+        else
+            layoutFiles.push_back(argv[i]);
+    }
+    if ((headless && (layoutFiles.empty() || imageSize <= 0)) || (!convertPath.empty() && layoutFiles.size() != 1))
+    {
+        print_usage(argv[0]);
+        return -1;
+    }
+    // The window shows the first layout file instead of the demo level when one is given
+    string layoutPath = !headless && !layoutFiles.empty() ? layoutFiles[0] : "";
+
+    // Converting needs no window: .garage writes the binary format, anything else text for diffing
+    if (!convertPath.empty())
+    {
+        // A binary file is written from its mapping a level at a time, a text file is read whole
+        GarageFile file;
+        GarageLayout layout;
+        vector<string> names;
+        vector<GarageLevelView> views;
+        bool read = GarageFile::Detect(layoutFiles[0]) ? file.Open(layoutFiles[0]) : load_garage_layout(layoutFiles[0], layout);
+        int levels = file.IsOpen() ? file.Levels() : (int)layout.Levels.size();
+        size_t stallCount = 0;
+        for (int i = 0; i < levels && read; i++)
+        {
+            GarageLevelView view;
+            if (file.IsOpen())
+                read = file.View(i, view);
+            else
+                view = layout.View(i);
+            names.push_back(file.IsOpen() ? file.LevelName(i) : string(layout.String(layout.Levels[i].name)));
+            views.push_back(view);
+            stallCount += view.stallCount;
+        }
+        bool written = read && save_layout_levels(convertPath, names, views);
+        file.Close();
+        if (!written)
+        {
+            cout << "Failed to convert layout: " << layoutFiles[0] << endl;
+            return 1;
+        }
+        cout << "Wrote " << levels << " levels, " << stallCount << " stalls to " << convertPath << endl;
+        return 0;
+    }
+
+    // Generating needs no window either: the site is searched on every core and saved like --convert
+    if (!sitePath.empty())
+    {
+        GarageSite site;
+        if (!load_garage_site(sitePath, site))
+            return 1;
+        ThreadPool pool;
+        LayoutGenerator generator;
+        generator.Seed = seed;
+        bool generated = generator.Generate(site, pool);
+        pool.Delete();
+        GarageLayout layout;
+        generator.Build(layout, "1");
+        if (!generated || !save_layout(generatedPath, layout))
+        {
+            cout << "Failed to generate a layout for: " << sitePath << endl;
+            return 1;
+        }
+        cout << "Generated " << generator.BestStalls << " stalls from " << generator.Candidates << " candidates into " << generatedPath << endl;
+        return 0;
+    }
+
+    // Simulating needs no window: the first layout file, or the demo level, is run for the given days
+    if (simulateDays > 0.0)
+    {
+        GarageLayout layout;
+        if (layoutFiles.empty())
+            build_demo_garage(layout);
+        else if (!load_garage_layout(layoutFiles[0], layout))
+            return 1;
+        OccupancySimulator simulator;
+        simulator.Seed = seed;
+        simulator.Reset(layout);
+        auto start = std::chrono::steady_clock::now();
+        simulator.RunUntil(simulateDays * 1440.0);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        cout << "Simulated " << simulateDays << " days of " << simulator.Capacity() << " stalls in " << seconds << " s" << endl;
+        cout << "Arrivals " << simulator.Arrivals << ", parked " << simulator.Parked << ", turned away " << simulator.TurnedAway
+            << ", peak " << simulator.PeakOccupied << ", average occupancy " << 100.0 * simulator.AverageOccupancy() << "%" << endl;
+        for (int h = 0; h < 24; h++)
+        {
+            double share = simulator.HourSamples[h] > 0 ? simulator.HourOccupancy[h] / simulator.HourSamples[h] : 0.0;
+            cout << (h < 10 ? "0" : "") << h << ":00 " << 100.0 * share << "%" << endl;
+        }
+        return 0;
+    }
+
+    // Packing needs no window: every shader, layout and sprite goes into one file
+    AssetVFS& assets = AssetVFS::Default();
+    if (!packPath.empty())
+    {
+        vector<string> names = assets.List("Resource_Files");
+        names.push_back("lib/deadpool.png");
+        if (!assets.WritePack(packPath, names))
+        {
+            cout << "Failed to write asset pack: " << packPath << endl;
+            return 1;
+        }
+        cout << "Packed " << names.size() << " assets into " << packPath << endl;
+        return 0;
+    }
+    // An assets.pak next to Resource_Files replaces the loose files it holds
+    assets.Mount(assets.Resolve("assets.pak"));
+
+    // Render servers have no display, so use GLFW's null platform with a surfaceless context
+    if (headless && glfwPlatformSupported(GLFW_PLATFORM_NULL))
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
 
     // Initalize GLFW
     glfwInit();
@@ -32,8 +345,21 @@ int main()
     // Tell GLFW  we are using the CORE profile which only includes modern functions
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+    if (headless)
+    {
+        // The window is never shown, everything is drawn into an FBO.
+        // EGL gives a surfaceless Mesa llvmpipe context, OSMesa is the fallback.
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    }
+
     // Create a GLFWwindow object that is 800 by 800 named Plot-a-Lot that is not fullscreen
     GLFWwindow *window = glfwCreateWindow(width, height, "Plot-a-Lot", NULL, NULL);
+    if (window == NULL && headless)
+    {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        window = glfwCreateWindow(width, height, "Plot-a-Lot", NULL, NULL);
+    }
 
     // If the window did not create output an error message
     if (window == NULL)
@@ -46,8 +372,8 @@ int main()
     // Introduce the window in the the current context
     glfwMakeContextCurrent(window);
 
-    // Load GLAD so it configures OpenGL
-    if (!gladLoadGL())
+    // Load GLAD so it configures OpenGL, through GLFW so EGL and OSMesa contexts work too
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
         cout << "Failed to initialize GLAD" << endl;
         glfwDestroyWindow(window);
@@ -55,17 +381,65 @@ int main()
         return -1;
     }
 
-    // Specify the viewport of OpenGL in the window
-    glViewport(0, 0, width, height);
+    // Every wrapper binds through this cache, so redundant binds never reach the driver
+    GLStateCache stateCache;
+    GLStateCache::MakeCurrent(&stateCache);
 
-    // Generates Shader object using shaders default.vert and default.frag
-    Shader shaderProgram("default.vert", "default.frag");
+    // Specify the viewport of OpenGL in the window, in framebuffer pixels which differ from
+    // window coordinates on HiDPI displays
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+
+    // Linked programs are kept in shader_cache so warm start-ups skip compiling
+    ShaderCache shaderCache("shader_cache");
+    // Every program and permutation is compiled and linked together up front
+    ShaderLibrary shaders(&shaderCache);
+    GLuint quadShader = shaders.Add("default.vert", "default.frag");
+    // Optional defines of stall.vert and stall.frag, as permutation bits
+    vector<string> stallDefines;
+    stallDefines.push_back("SPRITES");
+    stallDefines.push_back("HEATMAP");
+    stallDefines.push_back("AGGREGATE");
+    const GLuint STALL_SPRITES = 1u << 0;
+    const GLuint STALL_HEATMAP = 1u << 1;
+    const GLuint STALL_AGGREGATE = 1u << 2;
+    GLuint stallShader = shaders.Add("stall.vert", "stall.frag", stallDefines);
+    shaders.Request(quadShader);
+    shaders.Request(stallShader, STALL_SPRITES);
+    shaders.Request(stallShader, STALL_SPRITES | STALL_HEATMAP);
+    shaders.Request(stallShader);
+    shaders.Request(stallShader, STALL_AGGREGATE);
+    shaders.Request(stallShader, STALL_AGGREGATE | STALL_HEATMAP);
+    if (!shaders.Build())
+    {
+        cout << "Failed to build shaders" << endl;
+        shaders.Delete();
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return -1;
+    }
+    // Textured quad
+    Shader& shaderProgram = *shaders.Get(quadShader);
+    // Instanced stalls with their sprites, and the same with the occupancy heatmap (H)
+    Shader& stallProgram = *shaders.Get(stallShader, STALL_SPRITES);
+    Shader& heatmapProgram = *shaders.Get(stallShader, STALL_SPRITES | STALL_HEATMAP);
+    // Vehicles never carry a sprite, so they use the flat permutation
+    Shader& vehicleProgram = *shaders.Get(stallShader);
+    // Zoomed far out, groups of stalls are drawn as one quad colored by how many are taken
+    Shader& aggregateProgram = *shaders.Get(stallShader, STALL_AGGREGATE);
+    Shader& aggregateHeatmapProgram = *shaders.Get(stallShader, STALL_AGGREGATE | STALL_HEATMAP);
     
     // Create orthographic projection matrix (2D view: 0,0 at bottom-left, 800x800)
     glm::mat4 projection = glm::ortho(0.0f, width, 0.0f, height, -1.0f, 1.0f);
     
-    // Get the projection matrix uniform location (only need to do this once)
-    GLuint projLocation = glGetUniformLocation(shaderProgram.ID, "projection");
+    // Projection and view are shared by every program through the FrameUniforms block
+    FrameUniforms frameUniforms;
+    FrameUniformData frameData;
+    frameData.projection = projection;
+    frameData.view = glm::mat4(1.0f);
+    frameData.viewport = glm::vec4(0.0f, 0.0f, (float)framebufferWidth, (float)framebufferHeight);
+    frameData.time = 0.0f;
     
     // Vertices coordinates
     GLfloat vertices[] =
@@ -104,83 +478,598 @@ int main()
 	VBO1.Unbind();
 	EBO1.Unbind();
 
-	// Textures
-	int widthImg, heightImg, numColCh;
-	stbi_set_flip_vertically_on_load(true);
-    
-    unsigned char *bytes = stbi_load("C:/Users/handr/Documents/GitHub/plot-a-lot/lib/deadpool.png", &widthImg, &heightImg, &numColCh, 0);
+	// Unit quad centred on the origin, scaled and rotated per stall by stall.vert
+	GLfloat stallVertices[] =
+	{
+		-0.5f, -0.5f, 0.0f, 0.0f, 0.0f,
+		 0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
+		-0.5f,  0.5f, 0.0f, 0.0f, 1.0f,
+		 0.5f,  0.5f, 0.0f, 1.0f, 1.0f,
+	};
+	GLuint stallIndices[] =
+	{
+		0, 1, 3,
+		0, 3, 2
+	};
 
+	// The garage shown: the demo level, or the layout file given on the command line. A binary
+	// layout stays mapped and its levels are only copied into the garage once they are shown
+	GarageLayout garage;
+	build_demo_garage(garage);
+	GarageFile garageFile;
+	vector<bool> levelLoaded(garage.Levels.size(), true);
 
-	if (bytes == NULL)
+	// Stall VAO: shared quad geometry plus one StallInstance per stall
+	VAO stallVAO;
+	stallVAO.Bind();
+	VBO stallVBO(stallVertices, sizeof(stallVertices));
+	EBO stallEBO(stallIndices, sizeof(stallIndices));
+	stallVAO.LinkAttrib(stallVBO, 0, 3, GL_FLOAT, 5 * sizeof(float), (void*)0);
+	stallVAO.LinkAttrib(stallVBO, 1, 2, GL_FLOAT, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	stallVAO.Unbind();
+	stallEBO.Unbind();
+	if (!layoutPath.empty())
 	{
-		cout << "Failed to load texture: deadpool.png" << endl;
-		glfwDestroyWindow(window);
-		glfwTerminate();
-		return -1;
+		if (open_viewed_layout(layoutPath, garageFile, garage, levelLoaded))
+			frameData.projection = fit_layout_projection(garage.Levels[0].Bounds());
+		else
+			layoutPath.clear();
 	}
+	// One level is shown at a time (Page Up/Page Down); the culling, tiles and levels of
+	// detail work on its stalls as records, everything else reads the garage's columns
+	int shownLevel = 0;
+	glm::vec4 shownBounds = garage.Levels[shownLevel].Bounds();
+	vector<StallInstance> stalls;
+	garage.Instances(shownLevel, stalls);
+	StallInstanceBuffer stallInstances(stalls.data(), (GLsizei)stalls.size());
+	stallInstances.LinkAttribs(stallVAO, 2);
+	// Only the stalls in view are written into the instance buffer, found through the index of
+	// each level of detail; zoomed far out whole groups of stalls stand in for them
+	StallLOD stallLevels(4.0f);
+	stallLevels.Build(stalls);
 
-	GLuint texture;
-	glGenTextures(1, &texture);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	// Vehicles move every frame, so their records are streamed through a ring of frame regions
+	const GLsizei vehicleCount = 40;
+	VAO vehicleVAO;
+	vehicleVAO.Bind();
+	stallEBO.Bind();
+	vehicleVAO.LinkAttrib(stallVBO, 0, 3, GL_FLOAT, 5 * sizeof(float), (void*)0);
+	vehicleVAO.LinkAttrib(stallVBO, 1, 2, GL_FLOAT, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	vehicleVAO.Unbind();
+	stallEBO.Unbind();
+	StreamingVBO vehicleStream(vehicleCount * sizeof(StallInstance));
+	// Vehicles stay in their own index, moved every frame as they drive
+	LooseQuadtree vehicleTree(glm::vec2(0.0f), glm::vec2(width, height));
+	vector<StallInstance> vehicleRecords(vehicleCount);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	// Textures are decoded on worker threads and uploaded a little every frame,
+	// the quad shows a placeholder until its image is ready
+	// Decoded images are kept in texture_cache so warm start-ups skip PNG decoding
+	ThreadPool workers;
+	TextureCache textureCache("texture_cache");
+	TextureManager textures(workers, 2.0, &textureCache);
+	TextureHandle texture = textures.Load("lib/deadpool.png", GL_NEAREST, GL_REPEAT);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// Stall and vehicle icons are packed into one atlas so every stall shares one texture
+	TextureAtlas atlas(1024, 1024);
+	vector<string> spriteFiles;
+	spriteFiles.push_back("lib/deadpool.png");
+	atlas.AddFiles(spriteFiles);
+	atlas.Upload();
 
-	// Determine the format based on number of color channels
-	GLenum format = GL_RGB;
-	if (numColCh == 4)
-		format = GL_RGBA;
-	else if (numColCh == 1)
-		format = GL_RED;
+	// Samplers keep their unit until relinked, so tex0 and atlas are set here and after hot reloads
+	auto setProgramUniforms = [&]()
+	{
+		shaderProgram.Activate();
+		glUniform1i(shaderProgram.GetUniformLocation("tex0"), 0);
+		Shader* spritePrograms[] = { &stallProgram, &heatmapProgram };
+		for (int i = 0; i < 2; i++)
+		{
+			spritePrograms[i]->Activate();
+			glUniform1i(spritePrograms[i]->GetUniformLocation("atlas"), 0);
+			glUniform1i(spritePrograms[i]->GetUniformLocation("spriteCount"), (GLint)atlas.UVRects.size());
+			if (!atlas.UVRects.empty())
+				glUniform4fv(spritePrograms[i]->GetUniformLocation("spriteRects"), (GLsizei)atlas.UVRects.size(), glm::value_ptr(atlas.UVRects[0]));
+		}
+	};
+	setProgramUniforms();
+
+	// Draw commands for each frame are recorded here and replayed in state order
+	RenderQueue renderQueue;
+
+	// Batch export: every layout reuses the shaders, buffers and textures created above
+	int failedLayouts = 0;
+	if (headless)
+	{
+		textures.Finish();
+		FBO target(imageSize, imageSize);
+		bool targetComplete = target.IsComplete();
+		if (!targetComplete)
+		{
+			cout << "Failed to create offscreen framebuffer" << endl;
+			failedLayouts = (int)layoutFiles.size();
+		}
+		vector<unsigned char> pixels((size_t)imageSize * imageSize * 4);
+		// Whole levels are drawn, so the stall columns are uploaded as they are
+		StallColumnBuffer columns;
+		VAO columnVAO;
+		columnVAO.Bind();
+		stallEBO.Bind();
+		columnVAO.LinkAttrib(stallVBO, 0, 3, GL_FLOAT, 5 * sizeof(float), (void*)0);
+		columnVAO.LinkAttrib(stallVBO, 1, 2, GL_FLOAT, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+		columnVAO.Unbind();
+		stallEBO.Unbind();
+		columns.LinkAttribs(columnVAO, 2);
+		// Binary layouts are drawn straight from the mapping, a level at a time
+		GarageFile garageFile;
+		GarageLayout layout;
+		// A bad layout is reported by its loader and skipped, the rest of the batch still renders
+		for (size_t i = 0; i < layoutFiles.size() && targetComplete; i++)
+		{
+			bool binary = GarageFile::Detect(layoutFiles[i]);
+			if (binary ? !garageFile.Open(layoutFiles[i]) : !load_garage_layout(layoutFiles[i], layout))
+			{
+				failedLayouts++;
+				continue;
+			}
+			if (!binary && layout.Levels.empty())
+				layout.AddLevel("1");
+			// Every level of a multi-level layout gets its own image
+			int levels = binary ? garageFile.Levels() : (int)layout.Levels.size();
+			for (int level = 0; level < levels; level++)
+			{
+				GarageLevelView view;
+				if (!binary)
+					view = layout.View(level);
+				else if (!garageFile.View(level, view))
+				{
+					failedLayouts++;
+					break;
+				}
+				columns.Upload(view);
+				frameData.projection = fit_layout_projection(view.bounds);
+				frameData.viewport = glm::vec4(0.0f, 0.0f, (float)imageSize, (float)imageSize);
+				frameUniforms.Update(frameData);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, format, widthImg, heightImg, 0, format, GL_UNSIGNED_BYTE, bytes);
-	glGenerateMipmap(GL_TEXTURE_2D);
+				target.Bind();
+				glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
+				glClear(GL_COLOR_BUFFER_BIT);
+				renderQueue.Push(RenderQueue::Indexed(1, stallProgram.ID, atlas.ID, columnVAO.ID, 6, 0, columns.Count));
+				renderQueue.Execute(stateCache);
+				target.ReadPixels(pixels.data());
 
-	stbi_image_free(bytes);
-	glBindTexture(GL_TEXTURE_2D, 0);
+				string imagePath = thumbnail_path(outDir, layoutFiles[i], levels > 1 ? level : -1);
+				if (!write_png(imagePath, pixels.data(), imageSize, imageSize, 4, true))
+				{
+					cout << "Failed to write image: " << imagePath << endl;
+					failedLayouts++;
+					break;
+				}
+			}
+			garageFile.Close();
+		}
+		target.Unbind();
+		target.Delete();
+		columnVAO.Delete();
+		columns.Delete();
+		cout << "Rendered " << layoutFiles.size() - failedLayouts << " of " << layoutFiles.size() << " layouts" << endl;
+	}
+
+	// Screenshots (F12) and recordings (F9, or --record) are read back asynchronously
+	FrameCapture capture(framebufferWidth, framebufferHeight);
+	if (!headless && !recordPath.empty())
+	{
+		bool video = recordPath.size() > 4 && recordPath.compare(recordPath.size() - 4, 4, ".y4m") == 0;
+		capture.StartRecording(recordPath, video ? FrameCapture::Y4M : FrameCapture::PNG_SEQUENCE, 60);
+	}
+	int screenshotCount = 0;
+	bool screenshotKeyDown = false;
+	bool recordKeyDown = false;
+	bool heatmap = false;
+	bool heatmapKeyDown = false;
+	// Simulated occupancy sensors (O): about 1% of the stalls change every second
+	bool sensorFeed = false;
+	bool sensorKeyDown = false;
+	double sensorBacklog = 0.0;
+	// Seeded through --seed, so the same stalls change in every run
+	mt19937 sensorRandom(seed);
+	// CPU and GPU time of each part of the frame, F8 prints it and saves trace.json
+	Profiler profiler;
+	bool traceKeyDown = false;
+
+	// Frames are drawn only when something changed, or paced to 60 per second while animating
+	FrameScheduler scheduler(window, 60.0);
+
+	// Pan and zoom over the level; the stalls are culled again whenever the visible rectangle changes
+	Camera2D camera(frameData.projection);
+	double frameTime = glfwGetTime();
+	bool stallsCulled = false;
+	glm::vec4 culledRect(0.0f);
+	int culledLevel = 0;
+	vector<GLuint> visibleIDs;
+	vector<StallInstance> visibleStalls;
+	// Writes the elements of a level of detail overlapping rect into the instance buffer
+	auto uploadStalls = [&](const glm::vec4& rect, int level)
+	{
+		visibleStalls.clear();
+		stallLevels.Query(level, rect, visibleStalls);
+		stallInstances.Update(visibleStalls.data(), (GLsizei)visibleStalls.size());
+	};
+
+	// The stalls are drawn once into cached tiles and only redrawn where the layout is edited
+	TileCache tiles(256, 128);
+	tiles.ClearColor = glm::vec4(0.07f, 0.13f, 0.17f, 1.0f);
+	tiles.SetBounds(shownBounds);
+	// Draws the stalls of one tile, projected onto the tile's FBO
+	auto drawStaticTile = [&](const glm::vec4& rect)
+	{
+		FrameUniformData tileData = frameData;
+		tileData.projection = glm::ortho(rect.x, rect.z, rect.y, rect.w, -1.0f, 1.0f);
+		tileData.view = glm::mat4(1.0f);
+		tileData.viewport = glm::vec4(0.0f, 0.0f, (float)tiles.TilePixels, (float)tiles.TilePixels);
+		frameUniforms.Update(tileData);
+		int level = stallLevels.SelectLevel((float)tiles.TilePixels / (rect.z - rect.x));
+		uploadStalls(rect, level);
+		GLuint programID = level > 0 ? aggregateProgram.ID : stallProgram.ID;
+		renderQueue.Push(RenderQueue::Indexed(0, programID, atlas.ID, stallVAO.ID, 6, 0, stallInstances.Count));
+		renderQueue.Execute(stateCache);
+		// The instance buffer holds this tile's stalls now, not the ones in view
+		stallsCulled = false;
+	};
+
+	// Shows a level of the garage, with the camera fitted to it
+	auto showLevel = [&](int level)
+	{
+		// A level of a mapped layout that cannot be read is shown empty
+		if (!load_viewed_level(level, garageFile, garage, levelLoaded))
+			levelLoaded[level] = true;
+		shownLevel = level;
+		garage.Instances(shownLevel, stalls);
+		shownBounds = garage.Levels[shownLevel].Bounds();
+		stallLevels.Build(stalls);
+		tiles.SetBounds(shownBounds);
+		stallsCulled = false;
+		frameData.projection = fit_layout_projection(shownBounds);
+		camera.Reset(frameData.projection);
+	};
+	bool levelKeyDown = false;
+
+	// Changes the occupancy of one stall, redrawing only the tiles that show it or a group holding it;
+	// the stalls in view are written again, which uploads just the records that changed
+	vector<glm::vec4> changedBounds;
+	auto setStallState = [&](GLuint stall, GLuint state)
+	{
+		garage.SetState(shownLevel, stall, state);
+		stalls[stall].state = state;
+		stallLevels.SetState(stall, state, changedBounds);
+		for (size_t k = 0; k < changedBounds.size(); k++)
+		{
+			float minPixelsPerUnit, maxPixelsPerUnit;
+			stallLevels.PixelsPerUnitRange((int)k, minPixelsPerUnit, maxPixelsPerUnit);
+			float maxSize = minPixelsPerUnit > 0.0f ? tiles.TilePixels / minPixelsPerUnit : FLT_MAX;
+			tiles.Invalidate(changedBounds[k], tiles.TilePixels / maxPixelsPerUnit, maxSize);
+		}
+		stallsCulled = false;
+	};
+
+	// Occupancy simulation (T): an hour of traffic passes every second, stalls on the shown level
+	// are updated like sensor reports and those on other levels only in the garage
+	OccupancySimulator simulator;
+	simulator.Seed = seed;
+	simulator.OnStateChange = [&](int level, GLuint stall, GLuint state)
+	{
+		if (level == shownLevel)
+			setStallState(stall, state);
+		else
+			garage.SetState(level, stall, state);
+	};
+	bool simulating = false;
+	bool simulateKeyDown = false;
+	// Vehicles park on every level, so every level of a mapped layout is copied in first
+	auto resetSimulator = [&]()
+	{
+		for (int level = 0; level < (int)garage.Levels.size(); level++)
+		{
+			if (!load_viewed_level(level, garageFile, garage, levelLoaded))
+				levelLoaded[level] = true;
+		}
+		simulator.Reset(garage);
+	};
+
+	// Saved shaders, textures and the shown layout are reloaded without restarting
+	const string shaderDir = "Resource_Files/Shaders";
+	FileWatcher watcher([&scheduler] { scheduler.MarkDirty(); });
+	string layoutWatchName;
+	if (!headless)
+	{
+		watcher.Watch(assets.Resolve(shaderDir), shaderDir);
+		watcher.Watch(assets.Resolve("lib"), "lib");
+		if (!layoutPath.empty())
+		{
+			size_t slash = layoutPath.find_last_of("\\/");
+			string layoutDir = slash == string::npos ? "." : layoutPath.substr(0, slash);
+			layoutWatchName = layoutDir + "/" + layoutPath.substr(slash == string::npos ? 0 : slash + 1);
+			watcher.Watch(layoutDir, layoutDir);
+		}
+	}
 
     // Main while loop
-    while (!glfwWindowShouldClose(window))
+    while (!headless && scheduler.WaitForFrame())
     {
+		profiler.BeginFrame();
+		profiler.BeginCPU("frame");
+
+		// Rebuild only what changed; a shader or layout that fails to load keeps the old one
+		profiler.BeginCPU("reload");
+		vector<string> changedFiles = watcher.Poll();
+		for (size_t i = 0; i < changedFiles.size(); i++)
+		{
+			const string& file = changedFiles[i];
+			if (file.compare(0, shaderDir.size() + 1, shaderDir + "/") == 0)
+			{
+				if (shaders.Reload(file.substr(shaderDir.size() + 1)))
+				{
+					setProgramUniforms();
+					tiles.InvalidateAll();
+				}
+			}
+			else if (file == layoutWatchName)
+			{
+				if (open_viewed_layout(layoutPath, garageFile, garage, levelLoaded))
+				{
+					shownLevel = min(shownLevel, (int)garage.Levels.size() - 1);
+					if (!load_viewed_level(shownLevel, garageFile, garage, levelLoaded))
+						levelLoaded[shownLevel] = true;
+					vector<StallInstance> layout;
+					garage.Instances(shownLevel, layout);
+					// An edit that keeps the stall count and extent only redraws the tiles around changed stalls
+					if (layout.size() == stalls.size() && garage.Levels[shownLevel].Bounds() == shownBounds)
+					{
+						for (size_t j = 0; j < layout.size(); j++)
+						{
+							if (memcmp(&layout[j], &stalls[j], sizeof(StallInstance)) != 0)
+							{
+								tiles.Invalidate(instance_bounds(stalls[j]));
+								tiles.Invalidate(instance_bounds(layout[j]));
+							}
+						}
+						stalls = layout;
+						stallLevels.Build(stalls);
+						stallsCulled = false;
+					}
+					else
+						showLevel(shownLevel);
+					// The simulation's stall numbers refer to the old layout
+					if (simulating)
+						resetSimulator();
+				}
+			}
+			else
+				textures.Reload(file);
+		}
+		profiler.EndCPU();
+
+		// Move the camera for the keys held since the last frame, a long idle counts as one short step
+		double now = glfwGetTime();
+		float frameSeconds = (float)fmin(now - frameTime, 0.1);
+		frameTime = now;
+		bool cameraMoving = camera.Update(window, frameSeconds);
+		frameData.view = camera.View();
+		frameData.time = (float)now;
+		glm::vec4 visibleRect = camera.VisibleRect();
+		// Levels of detail and tiles are chosen by framebuffer pixels per layout unit
+		float pixelsPerUnit = framebufferWidth / (visibleRect.z - visibleRect.x);
+
+		// Free stalls become occupied and occupied ones free, as a live sensor feed would report
+		if (sensorFeed && !stalls.empty())
+		{
+			sensorBacklog += 0.01 * stalls.size() * frameSeconds;
+			for (; sensorBacklog >= 1.0; sensorBacklog -= 1.0)
+			{
+				GLuint stall = (GLuint)(sensorRandom() % stalls.size());
+				if (stalls[stall].state <= 1)
+					setStallState(stall, stalls[stall].state ^ 1);
+			}
+		}
+
+		// A frame advances the simulation by at most two minutes, so a stalled frame does not skip ahead
+		if (simulating)
+			simulator.RunUntil(simulator.Now() + 60.0 * fmin(frameSeconds, 1.0 / 30.0));
+
+		if (heatmap)
+		{
+			// The heatmap pulses every frame, so the stalls in view are drawn directly;
+			// zoomed in this costs what is on screen
+			profiler.BeginCPU("culling");
+			if (!stallsCulled || visibleRect != culledRect)
+			{
+				culledLevel = stallLevels.SelectLevel(pixelsPerUnit);
+				uploadStalls(visibleRect, culledLevel);
+				culledRect = visibleRect;
+				stallsCulled = true;
+			}
+			profiler.EndCPU();
+		}
+		else
+		{
+			// Draw the tiles in view that are missing or were edited, before the frame's own draws
+			profiler.BeginCPU("tiles");
+			profiler.BeginGPU("tiles");
+			tiles.Update(visibleRect, pixelsPerUnit, drawStaticTile);
+			profiler.EndGPU();
+			profiler.EndCPU();
+		}
+
 		// Specify the color of the background
 		glClearColor(0.07f, 0.13f, 0.17f, 1.0f);
 		// Clean the back buffer and assign the new color to it
 		glClear(GL_COLOR_BUFFER_BIT);
-		// Tell OpenGL which Shader Program we want to use
-		shaderProgram.Activate();
-		
-		// Set the projection matrix uniform
-		GLuint projLocation = glGetUniformLocation(shaderProgram.ID, "projection");
-		glUniformMatrix4fv(projLocation, 1, GL_FALSE, glm::value_ptr(projection));
-
-		// Bind the texture and set the texture uniform
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glUniform1i(glGetUniformLocation(shaderProgram.ID, "tex0"), 0);
-        
-		// Bind the VAO so OpenGL knows to use it
-		VAO1.Bind();
-		// Draw primitives, number of indices, datatype of indices, index of indices
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		// Upload the per-frame uniforms once for every program
+		frameUniforms.Update(frameData);
+
+		// Upload whatever finished decoding, within this frame's budget
+		profiler.BeginCPU("texture upload");
+		profiler.BeginGPU("texture upload");
+		textures.Update();
+		profiler.EndGPU();
+		profiler.EndCPU();
+
+		// Record this frame's draws, the queue sorts them by state before replaying
+		profiler.BeginCPU("commands");
+
+		// The textured quad and the vehicles belong to the demo level, a layout file is drawn on its own
+		bool demoLevel = layoutPath.empty();
+		if (demoLevel)
+			renderQueue.Push(RenderQueue::Indexed(1, shaderProgram.ID, textures.GetID(texture), VAO1.ID, 6));
+		// The stalls go underneath: a single instanced draw under the heatmap, otherwise a quad per cached tile
+		if (heatmap)
+		{
+			GLuint programID = culledLevel > 0 ? aggregateHeatmapProgram.ID : heatmapProgram.ID;
+			renderQueue.Push(RenderQueue::Indexed(0, programID, atlas.ID, stallVAO.ID, 6, 0, stallInstances.Count));
+		}
+		else
+			tiles.Record(renderQueue, 0, shaderProgram.ID);
+
+		// Stream this frame's vehicle positions and draw them with the flat stall shader
+		profiler.BeginCPU("simulation");
+		vehicleStream.BeginFrame();
+		float time = frameData.time;
+		for (int i = 0; i < vehicleCount; i++)
+		{
+			// Cars drive along the aisle between the rows and wrap around
+			StallInstance& vehicle = vehicleRecords[i];
+			vehicle.x = fmodf(i * 20.0f + time * 60.0f, width);
+			vehicle.y = 200.0f + (i % 2) * 20.0f;
+			vehicle.angle = 1.5707963f;
+			vehicle.width = 12.0f;
+			vehicle.depth = 24.0f;
+			vehicle.state = (GLuint)(i % 4);
+			vehicle.sprite = NO_SPRITE;
+			vehicleTree.Update((GLuint)i, instance_bounds(vehicle));
+		}
+		// Only the vehicles in view are streamed
+		visibleIDs.clear();
+		vehicleTree.Query(visibleRect, visibleIDs);
+		GLsizei visibleVehicles = (GLsizei)visibleIDs.size();
+		GLintptr vehicleOffset = 0;
+		StallInstance* vehicles = (StallInstance*)vehicleStream.Allocate(vehicleCount * sizeof(StallInstance), vehicleOffset);
+		if (vehicles != NULL)
+		{
+			for (GLsizei i = 0; i < visibleVehicles; i++)
+				vehicles[i] = vehicleRecords[visibleIDs[i]];
+		}
+		vehicleStream.Unmap();
+		profiler.EndCPU();
+		if (vehicles != NULL && demoLevel && visibleVehicles > 0)
+		{
+			StallInstanceBuffer::LinkAttribs(vehicleVAO, vehicleStream.ID, vehicleOffset, 2);
+			renderQueue.Push(RenderQueue::Indexed(2, vehicleProgram.ID, 0, vehicleVAO.ID, 6, 0, visibleVehicles));
+		}
+
+		profiler.EndCPU();
+
+		// Replay everything recorded this frame
+		profiler.BeginCPU("submit");
+		profiler.BeginGPU("draw");
+		renderQueue.Execute(stateCache);
+		profiler.EndGPU();
+		vehicleStream.EndFrame();
+		profiler.EndCPU();
+
+		// Queue the readback before the swap so the back buffer still holds this frame
+		profiler.BeginGPU("capture");
+		capture.Capture(0);
+		profiler.EndGPU();
+		profiler.EndFrame();
 		// Swap the back buffer with the front buffer
+		profiler.BeginCPU("swap");
 		glfwSwapBuffers(window);
-		// Take care of all GLFW events
-		glfwPollEvents();
+		profiler.EndCPU();
+
+		// React to the capture keys once per press
+		bool screenshotKey = glfwGetKey(window, GLFW_KEY_F12) == GLFW_PRESS;
+		if (screenshotKey && !screenshotKeyDown)
+			capture.Screenshot("screenshot_" + to_string(screenshotCount++) + ".png");
+		screenshotKeyDown = screenshotKey;
+		bool recordKey = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+		if (recordKey && !recordKeyDown)
+		{
+			if (capture.Recording)
+				capture.StopRecording();
+			else
+				capture.StartRecording("capture.y4m", FrameCapture::Y4M, 60);
+		}
+		recordKeyDown = recordKey;
+		bool heatmapKey = glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS;
+		if (heatmapKey && !heatmapKeyDown)
+			heatmap = !heatmap;
+		heatmapKeyDown = heatmapKey;
+		bool sensorKey = glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS;
+		if (sensorKey && !sensorKeyDown)
+			sensorFeed = !sensorFeed;
+		sensorKeyDown = sensorKey;
+		bool simulateKey = glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS;
+		if (simulateKey && !simulateKeyDown)
+		{
+			simulating = !simulating;
+			if (simulating)
+				resetSimulator();
+			else
+				cout << "Simulated " << simulator.Now() / 60.0 << " hours: " << simulator.Parked << " parked, " << simulator.TurnedAway
+					<< " turned away, average occupancy " << 100.0 * simulator.AverageOccupancy() << "%" << endl;
+		}
+		simulateKeyDown = simulateKey;
+		bool levelUpKey = glfwGetKey(window, GLFW_KEY_PAGE_UP) == GLFW_PRESS;
+		bool levelDownKey = glfwGetKey(window, GLFW_KEY_PAGE_DOWN) == GLFW_PRESS;
+		if ((levelUpKey || levelDownKey) && !levelKeyDown)
+		{
+			int level = shownLevel + (levelUpKey ? 1 : -1);
+			if (level >= 0 && level < (int)garage.Levels.size())
+			{
+				showLevel(level);
+				cout << "Level " << garage.String(garage.Levels[level].name) << ": " << stalls.size() << " stalls" << endl;
+			}
+		}
+		levelKeyDown = levelUpKey || levelDownKey;
+		bool traceKey = glfwGetKey(window, GLFW_KEY_F8) == GLFW_PRESS;
+		if (traceKey && !traceKeyDown)
+		{
+			profiler.Report(cout);
+			if (profiler.WriteTrace("trace.json"))
+				cout << "Saved trace.json" << endl;
+		}
+		traceKeyDown = traceKey;
+
+		// Keep drawing while the vehicles drive, the camera moves, the heatmap pulses, sensors report or the simulation runs,
+		// a recording runs or textures stream in
+		scheduler.Animating = demoLevel || cameraMoving || heatmap || sensorFeed || simulating || capture.Recording || textures.Pending() > 0;
+		profiler.EndCPU();
     }
 
 	// Delete all the objects we've created
+	watcher.Delete();
+	profiler.Delete();
 	VAO1.Delete();
 	VBO1.Delete();
 	EBO1.Delete();
-	glDeleteTextures(1, &texture);
-	shaderProgram.Delete();
+	stallVAO.Delete();
+	stallVBO.Delete();
+	stallEBO.Delete();
+	stallInstances.Delete();
+	tiles.Delete();
+	vehicleVAO.Delete();
+	vehicleStream.Delete();
+	garageFile.Close();
+	capture.Delete();
+	textures.Delete();
+	atlas.Delete();
+	workers.Delete();
+	shaders.Delete();
+	frameUniforms.Delete();
+	assets.Delete();
 
     // Terminate the window
     glfwDestroyWindow(window);
     glfwTerminate();
-    return 0;
+    return failedLayouts == 0 ? 0 : 1;
 }
\ No newline at end of file
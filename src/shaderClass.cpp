@@ -1,83 +1,46 @@
 #include"Header_Files/shaderClass.h"
-#ifdef _WIN32
-#include <windows.h>
-#include <direct.h>
-#define getcwd _getcwd
-#endif
-
-// Gets the directory where the executable is located
-std::string get_executable_dir()
-{
-#ifdef _WIN32
-	char path[MAX_PATH];
-	if (GetModuleFileNameA(NULL, path, MAX_PATH) != 0)
-	{
-		std::string exePath(path);
-		size_t lastSlash = exePath.find_last_of("\\/");
-		if (lastSlash != std::string::npos)
-		{
-			return exePath.substr(0, lastSlash + 1);
-		}
-	}
-	return "";
-#else
-	// For non-Windows, return empty (use relative paths)
-	return "";
-#endif
-}
+#include"Header_Files/GLStateCache.h"
+#include"Header_Files/FrameUniforms.h"
+#include"Header_Files/AssetVFS.h"
+#include<vector>
 
-// Reads a text file and outputs a string with everything in the text file
-// Tries multiple paths to find the shader file
+// Reads a shader file and outputs a string with everything in it. Bare file names are
+// looked up in Resource_Files/Shaders through the asset VFS, other paths are read as given
 std::string get_file_contents(const char* filename)
 {
-	std::string exeDir = get_executable_dir();
-	
-	// Try multiple possible paths
-	std::string paths[] = {
-		filename,                                    // Try as-is
-		std::string("Resource_Files/Shaders/") + filename,  // Try relative to current dir
-		std::string("../Resource_Files/Shaders/") + filename, // Try one level up
-		std::string("../../Resource_Files/Shaders/") + filename, // Try two levels up
-		exeDir + filename,                          // Try relative to exe
-		exeDir + "Resource_Files/Shaders/" + filename,  // Try exe dir + Resource_Files
-		exeDir + "../Resource_Files/Shaders/" + filename, // Try exe dir parent + Resource_Files
-	};
-	
-	const int numPaths = sizeof(paths) / sizeof(paths[0]);
-	
-	for (int i = 0; i < numPaths; i++)
-	{
-		std::ifstream in(paths[i], std::ios::binary);
-		if (in)
-		{
-			std::string contents;
-			in.seekg(0, std::ios::end);
-			contents.resize(in.tellg());
-			in.seekg(0, std::ios::beg);
-			in.read(&contents[0], contents.size());
-			in.close();
-			return(contents);
-		}
-	}
-	
-	// If all paths failed, throw error
+	AssetVFS& assets = AssetVFS::Default();
+	std::string contents;
+	if (assets.Read(std::string("Resource_Files/Shaders/") + filename, contents) || assets.Read(filename, contents))
+		return(contents);
+
 	std::cerr << "ERROR: Failed to open shader file: " << filename << std::endl;
-	std::cerr << "Executable directory: " << (exeDir.empty() ? "(unknown)" : exeDir) << std::endl;
-	std::cerr << "Tried paths:" << std::endl;
-	for (int i = 0; i < numPaths; i++)
-	{
-		std::cerr << "  - " << paths[i] << std::endl;
-	}
+	std::cerr << "Asset root: " << (assets.Root.empty() ? "(working directory)" : assets.Root) << std::endl;
 	throw(errno);
 }
 
 // Constructor that build the Shader Program from 2 different shaders
-Shader::Shader(const char* vertexFile, const char* fragmentFile)
+Shader::Shader(const char* vertexFile, const char* fragmentFile, ShaderCache* cache)
 {
 	// Read vertexFile and fragmentFile and store the strings
 	std::string vertexCode = get_file_contents(vertexFile);
 	std::string fragmentCode = get_file_contents(fragmentFile);
 
+	// A cached binary skips compiling and linking entirely
+	uint64_t cacheKey = 0;
+	if (cache != NULL && cache->Supported)
+	{
+		std::vector<std::string> parts;
+		parts.push_back(vertexCode);
+		parts.push_back(fragmentCode);
+		cacheKey = cache->Key(parts);
+		ID = cache->Load(cacheKey);
+		if (ID != 0)
+		{
+			Reflect();
+			return;
+		}
+	}
+
 	// Convert the shader source strings into character arrays
 	const char* vertexSource = vertexCode.c_str();
 	const char* fragmentSource = fragmentCode.c_str();
@@ -101,23 +64,99 @@ Shader::Shader(const char* vertexFile, const char* fragmentFile)
 	// Attach the Vertex and Fragment Shaders to the Shader Program
 	glAttachShader(ID, vertexShader);
 	glAttachShader(ID, fragmentShader);
+	// Ask the driver to keep the binary retrievable so it can be cached
+	if (cache != NULL && cache->Supported)
+		glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	// Wrap-up/Link all the shaders together into the Shader Program
 	glLinkProgram(ID);
+	if (cache != NULL)
+		cache->Store(cacheKey, ID);
 
 	// Delete the now useless Vertex and Fragment Shader objects
 	glDeleteShader(vertexShader);
 	glDeleteShader(fragmentShader);
 
+	// Cache every uniform location now so the render loop never looks one up by name
+	Reflect();
+}
+
+// Constructor that takes ownership of an already linked Shader Program
+Shader::Shader(GLuint program)
+{
+	ID = program;
+	Reflect();
+}
+
+// Reflects all active uniforms and uniform blocks and binds the shared blocks
+void Shader::Reflect()
+{
+	uniformLocations.clear();
+	uniformBlockIndices.clear();
+
+	GLint count = 0;
+	GLint maxLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	std::vector<GLchar> name(maxLength > 0 ? maxLength : 1);
+	for (GLint i = 0; i < count; i++)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ID, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+		std::string uniformName(name.data(), length);
+		// Members of uniform blocks have no location and are set through their buffer
+		GLint location = glGetUniformLocation(ID, uniformName.c_str());
+		if (location < 0)
+			continue;
+		uniformLocations[uniformName] = location;
+		// Arrays are reported as "name[0]", also make them reachable as "name"
+		size_t bracket = uniformName.find('[');
+		if (bracket != std::string::npos)
+			uniformLocations[uniformName.substr(0, bracket)] = location;
+	}
+
+	count = 0;
+	maxLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+	name.assign(maxLength > 0 ? maxLength : 1, 0);
+	for (GLint i = 0; i < count; i++)
+	{
+		GLsizei length = 0;
+		glGetActiveUniformBlockName(ID, (GLuint)i, (GLsizei)name.size(), &length, name.data());
+		uniformBlockIndices[std::string(name.data(), length)] = (GLuint)i;
+	}
+
+	// Every program reads the per-frame data from the same binding point
+	GLuint frameBlock = GetUniformBlockIndex(FRAME_UNIFORMS_BLOCK);
+	if (frameBlock != GL_INVALID_INDEX)
+		glUniformBlockBinding(ID, frameBlock, FRAME_UNIFORMS_BINDING);
+}
+
+// Returns the cached location of an active uniform, -1 if the program has no such uniform
+GLint Shader::GetUniformLocation(const std::string& name) const
+{
+	std::unordered_map<std::string, GLint>::const_iterator it = uniformLocations.find(name);
+	return it != uniformLocations.end() ? it->second : -1;
+}
+
+// Returns the cached index of an active uniform block, GL_INVALID_INDEX if there is none
+GLuint Shader::GetUniformBlockIndex(const std::string& name) const
+{
+	std::unordered_map<std::string, GLuint>::const_iterator it = uniformBlockIndices.find(name);
+	return it != uniformBlockIndices.end() ? it->second : GL_INVALID_INDEX;
 }
 
 // Activates the Shader Program
 void Shader::Activate()
 {
-	glUseProgram(ID);
+	GLStateCache::Current().UseProgram(ID);
 }
 
 // Deletes the Shader Program
 void Shader::Delete()
 {
+	GLStateCache::Current().ForgetProgram(ID);
 	glDeleteProgram(ID);
 }
\ No newline at end of file